@@ -0,0 +1,113 @@
+#include "Vitrae/Containers/StableMap.hpp"
+#include "Vitrae/Data/StringId.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Vitrae;
+
+namespace
+{
+/**
+ * A StringId that isn't a PackedKey, so StableMap falls back to the binary search
+ */
+struct BinarySearchKey
+{
+    StringId id;
+
+    bool operator==(const BinarySearchKey &other) const { return id == other.id; }
+    bool operator<(const BinarySearchKey &other) const { return id < other.id; }
+};
+
+constexpr std::size_t NUM_LOOKUPS = 1 << 22;
+constexpr int NUM_REPEATS = 5;
+
+/**
+ * @returns The fastest time per lookup in nanoseconds, over several repeats
+ */
+template <class KeyT>
+double timeLookups(const StableMap<KeyT, std::uint64_t> &map, const std::vector<KeyT> &lookups,
+                   std::uint64_t &checksum)
+{
+    double bestNs = std::numeric_limits<double>::max();
+
+    for (int repeat = 0; repeat < NUM_REPEATS; ++repeat) {
+        auto start = std::chrono::steady_clock::now();
+
+        std::uint64_t sum = 0;
+        for (const KeyT &key : lookups) {
+            sum += (*map.find(key)).second;
+        }
+
+        auto end = std::chrono::steady_clock::now();
+        bestNs = std::min(bestNs, std::chrono::duration<double, std::nano>(end - start).count() /
+                                      lookups.size());
+        checksum += sum;
+    }
+
+    return bestNs;
+}
+} // namespace
+
+/**
+ * Compares StableMap lookups of StringId keys, which use the packed linear search for small maps,
+ * with lookups of the same keys through the binary search
+ */
+int main()
+{
+#if defined(__AVX2__)
+    std::cout << "Packed search kernel: AVX2" << std::endl;
+#else
+    std::cout << "Packed search kernel: scalar" << std::endl;
+#endif
+    std::cout << "Linear search used up to " << PACKED_LINEAR_SEARCH_MAX_SIZE << " keys"
+              << std::endl;
+    std::cout << std::setw(6) << "keys" << std::setw(16) << "packed ns" << std::setw(16)
+              << "binary ns" << std::endl;
+
+    std::mt19937_64 random(42);
+    std::uint64_t checksum = 0;
+
+    for (std::size_t numKeys : {8, 16, 24, 32, 48, 64}) {
+        StableMap<StringId, std::uint64_t> packedMap;
+        StableMap<BinarySearchKey, std::uint64_t> binaryMap;
+        std::vector<StringId> keys;
+
+        for (std::size_t i = 0; i < numKeys; ++i) {
+            StringId key = StringId(std::string("property_") + std::to_string(i));
+            keys.push_back(key);
+            packedMap.emplace(key, i);
+            binaryMap.emplace(BinarySearchKey{key}, i);
+        }
+
+        // random order, so the branches of the binary search can't be predicted
+        std::uniform_int_distribution<std::size_t> keyDistribution(0, numKeys - 1);
+        std::vector<StringId> packedLookups;
+        std::vector<BinarySearchKey> binaryLookups;
+        packedLookups.reserve(NUM_LOOKUPS);
+        binaryLookups.reserve(NUM_LOOKUPS);
+        for (std::size_t i = 0; i < NUM_LOOKUPS; ++i) {
+            StringId key = keys[keyDistribution(random)];
+            packedLookups.push_back(key);
+            binaryLookups.push_back(BinarySearchKey{key});
+        }
+
+        double packedNs = timeLookups(packedMap, packedLookups, checksum);
+        double binaryNs = timeLookups(binaryMap, binaryLookups, checksum);
+
+        std::cout << std::setw(6) << numKeys << std::fixed << std::setprecision(2)
+                  << std::setw(16) << packedNs << std::setw(16) << binaryNs << std::endl;
+    }
+
+    // keeps the lookups from being optimized out
+    std::cout << "Checksum: " << checksum << std::endl;
+
+    return 0;
+}
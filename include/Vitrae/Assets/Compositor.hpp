@@ -1,14 +1,19 @@
 #pragma once
 
 #include "Vitrae/Params/ParamList.hpp"
+#include "Vitrae/Pipelines/Compositing/Executor.hpp"
 #include "Vitrae/Pipelines/Compositing/Task.hpp"
 #include "Vitrae/Pipelines/Pipeline.hpp"
 #include "Vitrae/Pipelines/PipelineMemory.hpp"
+#include "Vitrae/Pipelines/TaskGraph.hpp"
 
 #include "dynasma/keepers/abstract.hpp"
 #include "dynasma/managers/abstract.hpp"
 #include "dynasma/pointer.hpp"
 
+#include <future>
+#include <memory>
+
 namespace Vitrae
 {
 class FrameStore;
@@ -22,9 +27,33 @@ class Compositor : public dynasma::PolymorphicBase
 
     std::size_t memory_cost() const;
 
+    /**
+     * Sets the aliases, rebuilding only the parts of the pipeline that depend on changed ones
+     * @note If no tasks are affected, the pipeline and its memory are kept as they are
+     * @note With async rebuilds, the previous pipeline keeps running until the new one is solved
+     */
     void setParamAliases(const ParamAliases &aliases);
     void setDesiredProperties(const ParamList &properties);
 
+    /**
+     * Sets the number of worker threads for running independent tasks concurrently
+     * @param numWorkers The number of workers. With 0 (default), all tasks run sequentially on the
+     * thread calling compose()
+     * @note Only tasks that canRunConcurrently() are given to the workers
+     */
+    void setWorkerCount(std::size_t numWorkers);
+
+    /**
+     * Sets whether pipelines for changed aliases are solved on a background thread.
+     * Until the new pipeline is solved, compose() keeps running the previous one with the
+     * previous aliases. The pipelines are swapped at the start of a compose() call, where the
+     * local assets of the new one are prepared
+     * @note Rebuilds requested by tasks and changes of the desired properties are still done
+     * synchronously, since the previous pipeline can't be used anymore
+     * @note The compose method mustn't be modified while a pipeline is being solved
+     */
+    void setAsyncRebuild(bool enabled);
+
     /**
      * @returns the input specs required by the built pipeline
      */
@@ -58,12 +87,69 @@ class Compositor : public dynasma::PolymorphicBase
     ParamList m_desiredProperties;
     ParamAliases m_aliases;
 
+    /**
+     * The aliases the current pipeline was built for
+     */
+    ParamAliases m_pipelineAliases;
+
     bool m_needsRebuild;
     bool m_needsFrameStoreRegeneration;
-    Pipeline<ComposeTask> m_pipeline;
+    std::shared_ptr<const Pipeline<ComposeTask>> mp_pipeline;
+    TaskGraph<ComposeTask> m_taskGraph;
+    std::unique_ptr<ComposeExecutor> mp_executor;
+    ParamList m_inputSpecs;
     RestartablePipelineMemory m_pipelineMemory;
+    ComposeRequests m_requests;
     VariantScope m_localProperties;
+
+    /**
+     * A pipeline solved on the background thread, with the aliases it was solved for
+     */
+    struct SolvedPipeline
+    {
+        ParamAliases aliases;
+        std::shared_ptr<const Pipeline<ComposeTask>> p_pipeline;
+        TaskGraph<ComposeTask> taskGraph;
+    };
+
+    bool m_asyncRebuild;
+
+    /**
+     * The pipeline being solved in the background, if any. Declared last so it is finished
+     * before anything else is destroyed
+     */
+    std::future<SolvedPipeline> m_pendingPipeline;
+
     void regenerateFrameStores();
+
+    /**
+     * Keeps, retargets or rebuilds the pipeline after the aliases have changed
+     */
+    void updatePipelineForAliases();
+
+    /**
+     * Makes the pipeline current, to be prepared before the next run
+     */
+    void setPipeline(std::shared_ptr<const Pipeline<ComposeTask>> p_pipeline,
+                     TaskGraph<ComposeTask> taskGraph);
+
+    void startSolvingPipeline();
+
+    /**
+     * Swaps in the pipeline solved in the background, if it is ready and still wanted
+     * @throws PipelineSetupException if the pipeline couldn't be solved
+     */
+    void adoptSolvedPipeline();
+
+    /**
+     * Waits for the pipeline being solved in the background and drops it
+     */
+    void discardSolvedPipeline();
+
+    /**
+     * Marks the pipeline for rebuild because the requirements of its tasks changed
+     */
+    void invalidatePipelines();
 };
 
 } // namespace Vitrae
\ No newline at end of file
@@ -12,6 +12,7 @@
 #include "dynasma/pointer.hpp"
 
 #include <filesystem>
+#include <optional>
 #include <span>
 #include <vector>
 
@@ -32,6 +33,11 @@ class Model : public dynasma::PolymorphicBase
     {
         ComponentRoot &root;
         const aiMesh *p_extMesh;
+
+        /**
+         * The result of computeMinEdgeLength() for the mesh, if it was already computed
+         */
+        std::optional<float> minEdgeLength = std::nullopt;
     };
 
     struct FormParams
@@ -39,6 +45,7 @@ class Model : public dynasma::PolymorphicBase
         ComponentRoot &root;
         StableMap<StringId, DetailFormVector> formsByPurpose;
         dynasma::LazyPtr<Material> p_material;
+        BoundingBox boundingBox = {};
     };
 
     Model(const AssimpLoadParams &params);
@@ -77,6 +84,13 @@ class Model : public dynasma::PolymorphicBase
     void addForm(StringId purpose, std::shared_ptr<LoDMeasure> lodMeasure,
                  dynasma::LazyPtr<Shape> p_shape);
 
+    /**
+     * Replaces all forms with the visual form of the mesh, the same way constructing from the
+     * params does. Forms of other purposes are generated again when requested
+     * @note Used to swap in the meshes of models created with placeholder forms
+     */
+    void loadVisualFormFromAssimp(const AssimpLoadParams &params);
+
     /**
      * Replaces all the forms with the given purpose
      * @param purpose The purpose of the form
@@ -86,6 +100,13 @@ class Model : public dynasma::PolymorphicBase
 
     inline const BoundingBox &getBoundingBox() const { return m_boundingBox; }
 
+    /**
+     * @returns The length of the shortest triangle edge of the mesh
+     * @throws std::runtime_error if a triangle has an invalid vertex index
+     * @note Only reads the mesh, so meshes can be processed on multiple threads
+     */
+    static float computeMinEdgeLength(const aiMesh &extMesh);
+
   protected:
     ComponentRoot &m_root;
     dynasma::LazyPtr<Material> mp_material;
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "Vitrae/Data/BoundingVolumeHierarchy.hpp"
+#include "Vitrae/Data/Frustum.hpp"
+#include "Vitrae/Data/TransformStore.hpp"
 #include "Vitrae/Data/Transformation.hpp"
 
 #include "assimp/scene.h"
@@ -7,12 +10,20 @@
 #include "dynasma/managers/abstract.hpp"
 #include "dynasma/pointer.hpp"
 
+#include <chrono>
+#include <cstdint>
 #include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
 
 namespace Vitrae
 {
 class ComponentRoot;
+class Material;
 class Model;
+class Shape;
 
 class Camera : public SimpleTransformation
 {
@@ -39,7 +50,11 @@ class DirectionalLight
 struct ModelProp
 {
     dynasma::FirmPtr<Model> p_model;
-    SimpleTransformation transform;
+
+    /**
+     * The index of the prop's transformation in the scene's propTransforms
+     */
+    std::size_t transformIndex;
 };
 
 /**
@@ -53,28 +68,198 @@ class Scene : public dynasma::PolymorphicBase
         ComponentRoot &root;
         const aiScene *p_extScene;
         std::filesystem::path sceneFilepath;
+
+        /**
+         * The number of worker threads processing the meshes while assets are created.
+         * With 0 (default), everything is loaded on the calling thread
+         * @note Assets are always created on the calling thread and in the same order
+         */
+        std::size_t numWorkers = 0;
+
+        /**
+         * The shortest edge lengths of the meshes, if already known, such as from a scene cache.
+         * Computed while loading if empty (default)
+         */
+        std::span<const float> meshMinEdgeLengths = {};
+    };
+    struct StreamingParams
+    {
+        /**
+         * The form of the models whose meshes aren't loaded yet
+         */
+        dynasma::LazyPtr<Shape> p_placeholderShape;
+
+        /**
+         * The material of the models whose meshes aren't loaded yet
+         */
+        dynasma::LazyPtr<Material> p_placeholderMaterial;
+
+        /**
+         * How far the camera has to move for the loading order to be updated
+         */
+        float reprioritizeDistance = 1.0f;
+
+        /**
+         * The number of continueStreaming() calls after which the loading order is updated even
+         * if the camera didn't move, to account for moved props
+         */
+        std::size_t reprioritizeInterval = 60;
     };
     struct FileLoadParams
     {
         ComponentRoot &root;
         std::filesystem::path filepath;
+
+        /**
+         * Same as AssimpLoadParams::numWorkers
+         */
+        std::size_t numWorkers = 0;
+
+        /**
+         * The file to cache the imported scene in, to skip importing it while the source file
+         * stays the same. With an empty path (default), the scene is always imported
+         */
+        std::filesystem::path cacheFilepath = {};
+
+        /**
+         * If set, the scene is imported in the background and starts empty. The props are then
+         * added with placeholder models, whose meshes and materials are loaded by
+         * continueStreaming(). With std::nullopt (default), everything is loaded immediately
+         */
+        std::optional<StreamingParams> streaming = std::nullopt;
     };
 
     Scene(const AssimpLoadParams &params);
     Scene(const FileLoadParams &params);
+    ~Scene();
 
     std::size_t memory_cost() const;
 
+    /**
+     * Adds a prop along with its transformation
+     * @returns The added prop
+     */
+    ModelProp &addModelProp(dynasma::FirmPtr<Model> p_model, const SimpleTransformation &transform);
+
+    /**
+     * @returns The transformation of the prop
+     */
+    inline SimpleTransformation getPropTransform(const ModelProp &prop) const
+    {
+        return propTransforms.get(prop.transformIndex);
+    }
+
+    /**
+     * Sets the transformation of the prop. Its model matrix and culling bounds are updated by the
+     * next updatePropHierarchy()
+     */
+    inline void setPropTransform(const ModelProp &prop, const SimpleTransformation &transform)
+    {
+        propTransforms.set(prop.transformIndex, transform);
+    }
+
+    /**
+     * @returns The model matrix of the prop, as of the last propTransforms.updateMatrices()
+     */
+    inline const glm::mat4 &getPropModelMatrix(const ModelProp &prop) const
+    {
+        return propTransforms.getModelMatrix(prop.transformIndex);
+    }
+
+    /**
+     * @returns The bounding box of the prop's model, transformed to the world space
+     */
+    BoundingBox getPropWorldBoundingBox(const ModelProp &prop) const;
+
+    /**
+     * Rebuilds the spatial index of the modelProps, updating their transformations first.
+     * Needs to be called after the props are added, removed or moved
+     * @note Props added since the last rebuild are treated as always visible
+     */
+    void rebuildPropHierarchy();
+
+    /**
+     * Updates the matrices of the moved props, and refits the spatial index to their new bounding
+     * boxes. Much cheaper than rebuildPropHierarchy() when few props move, but culling gets less
+     * efficient the further they move from where they were when it was rebuilt
+     * @note Props added or removed since the last rebuild still need rebuildPropHierarchy()
+     */
+    void updatePropHierarchy();
+
+    /**
+     * Appends the props whose world bounding boxes intersect the frustum, in no particular order
+     */
+    void collectPropsInFrustum(const Frustum &frustum,
+                               std::vector<const ModelProp *> &outProps) const;
+
+    /**
+     * @returns Whether the scene has assets left to load by continueStreaming()
+     */
+    inline bool isStreaming() const { return mp_streamingState != nullptr; }
+
+    /**
+     * Continues loading the streamed scene. Once the background import finishes, adds the props
+     * with placeholder models and sets the camera. Afterwards, replaces the placeholders with the
+     * loaded meshes and materials, for the models closest to the camera first, until the time
+     * budget runs out
+     * @returns Whether any assets are still left to load
+     * @note Must be called on the thread that creates the assets, such as once per frame
+     * @note At least one model is loaded per call, even if it takes longer than the budget
+     */
+    bool continueStreaming(std::chrono::steady_clock::duration timeBudget);
+
     /*
     Scene parts (to be replaced with a more modular approach)
     */
 
     std::vector<ModelProp> modelProps;
+
+    /**
+     * The transformations of the modelProps. Matrices of the moved props are recomputed by
+     * updatePropHierarchy(), so static props cost nothing per frame
+     * @note Renderers only read the matrices and the spatial index. Whoever moves the props has to
+     * call updatePropHierarchy() or rebuildPropHierarchy() before the scene is rendered, typically
+     * once per frame. Calling propTransforms.updateMatrices() directly would leave the props
+     * culled by their old bounding boxes
+     */
+    TransformStore propTransforms;
     Camera camera;
     DirectionalLight light;
 
   protected:
-    void loadFromAssimp(const AssimpLoadParams &params);
+    struct StreamingState;
+
+    static constexpr std::uint32_t NO_PROP = ~std::uint32_t(0);
+
+    BoundingVolumeHierarchy m_propHierarchy;
+
+    /**
+     * The index of the prop using each transformation as of the last rebuildPropHierarchy(), or
+     * NO_PROP
+     */
+    std::vector<std::uint32_t> m_propIndexPerTransform;
+
+    /**
+     * The state of loading the streamed scene, or nullptr once it's fully loaded
+     */
+    std::unique_ptr<StreamingState> mp_streamingState;
+
+    /**
+     * @returns The shortest edge lengths of the meshes
+     */
+    std::vector<float> loadFromAssimp(const AssimpLoadParams &params);
+
+    /**
+     * Adds the props of the scene's node tree, using the models of the meshes
+     * @returns The mesh index of each added prop
+     */
+    std::vector<std::uint32_t> addPropsFromAssimp(
+        const aiScene &extScene, std::span<const dynasma::FirmPtr<Model>> modelById);
+    void loadCameraFromAssimp(const aiScene &extScene);
+
+    void updateStreamedMeshDistances();
+    void addStreamedPlaceholders();
+    void loadStreamedModel(std::uint32_t meshIndex);
 };
 
 } // namespace Vitrae
\ No newline at end of file
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "assimp/scene.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace Vitrae
+{
+
+/**
+ * The version of the scene cache format. Caches of other versions are ignored
+ */
+constexpr std::uint32_t SCENE_CACHE_VERSION = 2;
+
+/**
+ * @returns The key identifying the scene imported from the file with the import flags
+ * @note Hashes the whole file, which is still much faster than importing it
+ * @throws std::runtime_error if the file can't be read
+ */
+std::uint64_t computeSceneCacheKey(const std::filesystem::path &sourceFilepath,
+                                   unsigned int importFlags);
+
+/**
+ * Writes the parts of the imported scene used by the engine to the cache file, along with the
+ * shortest edge lengths of its meshes. The vertex and index arrays are aligned, so reading the
+ * cache can use them in place
+ * @note The cache uses the native byte order, so it is only valid on the machine that wrote it
+ * @throws std::invalid_argument if a mesh has faces of different sizes, which can't be stored
+ * @throws std::runtime_error if the file can't be written
+ */
+void writeSceneCache(const std::filesystem::path &cacheFilepath, std::uint64_t key,
+                     const aiScene &extScene, std::span<const float> meshMinEdgeLengths);
+
+/**
+ * A scene read from the cache file. The vertex and index arrays of its meshes point into the read
+ * file data, which is kept along with the scene instead of being copied out of it
+ * @note The rest of the scene, such as the materials, nodes and the faces pointing to the indices,
+ * is small and copied into assimp's own structures
+ */
+class CachedScene
+{
+  public:
+    CachedScene(const CachedScene &) = delete;
+    CachedScene &operator=(const CachedScene &) = delete;
+    ~CachedScene();
+
+    inline const aiScene &getScene() const { return *mp_extScene; }
+
+  private:
+    friend std::unique_ptr<CachedScene> readSceneCache(const std::filesystem::path &cacheFilepath,
+                                                       std::uint64_t key,
+                                                       std::vector<float> &outMeshMinEdgeLengths);
+
+    std::unique_ptr<std::byte[]> mp_data;
+
+    /**
+     * The scene, destroyed before the data its arrays point into
+     */
+    std::unique_ptr<aiScene> mp_extScene;
+
+    CachedScene() = default;
+};
+
+/**
+ * Reads the scene back from the cache file, without running the importer
+ * @returns The scene, or nullptr if the cache doesn't exist or was written for another key or
+ * version
+ * @throws std::runtime_error if the cache is corrupted
+ */
+std::unique_ptr<CachedScene> readSceneCache(const std::filesystem::path &cacheFilepath,
+                                            std::uint64_t key,
+                                            std::vector<float> &outMeshMinEdgeLengths);
+
+} // namespace Vitrae
\ No newline at end of file
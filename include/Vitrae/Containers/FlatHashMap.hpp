@@ -0,0 +1,564 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory_resource>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+namespace Vitrae
+{
+
+/**
+ * @brief An open-addressing hash map with linear probing, meant for keys that are frequently
+ * inserted and looked up, but rarely iterated in order
+ * @note Keys are expected to already be well distributed hashes (like StringId), so only a cheap
+ * fibonacci scramble is applied to choose the home slot
+ * @note Inserting can invalidate iterators and references; erasing can move other elements
+ * @note The slots are allocated from a std::pmr::memory_resource, so short-lived maps can use an
+ * arena. As with pmr containers, copies use the default resource and moves keep the source's one
+ *
+ * @tparam KeyT the type of the key
+ * @tparam MappedT the type of the value
+ * @tparam HashT the hashing functor type
+ */
+template <class KeyT, class MappedT, class HashT = std::hash<KeyT>> class FlatHashMap
+{
+    template <class KeyRefT, class MappedRefT> class AbstractFlatHashMapIterator
+    {
+        friend class FlatHashMap;
+
+        const std::uint8_t *mp_occupancy;
+        KeyRefT *mp_key;
+        MappedRefT *mp_value;
+        std::size_t m_index;
+        std::size_t m_capacity;
+
+        AbstractFlatHashMapIterator(const std::uint8_t *occupancy, KeyRefT *keys,
+                                    MappedRefT *values, std::size_t index, std::size_t capacity)
+            : mp_occupancy(occupancy), mp_key(keys), mp_value(values), m_index(index),
+              m_capacity(capacity)
+        {
+            skipEmpty();
+        }
+
+        void skipEmpty()
+        {
+            while (m_index < m_capacity && !mp_occupancy[m_index]) {
+                ++m_index;
+            }
+        }
+
+      public:
+        using iterator_category = std::forward_iterator_tag;
+
+        using value_type = std::pair<KeyRefT &, MappedRefT &>;
+
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+        using pointer = std::pair<KeyRefT *, MappedRefT *>;
+        using reference = std::pair<KeyRefT &, MappedRefT &>;
+
+        AbstractFlatHashMapIterator()
+            : mp_occupancy(nullptr), mp_key(nullptr), mp_value(nullptr), m_index(0), m_capacity(0)
+        {}
+        AbstractFlatHashMapIterator(const AbstractFlatHashMapIterator &) = default;
+        AbstractFlatHashMapIterator(AbstractFlatHashMapIterator &&) = default;
+
+        template <class OtherKeyRefT, class OtherMappedRefT>
+            requires(std::convertible_to<OtherKeyRefT *, KeyRefT *> &&
+                     std::convertible_to<OtherMappedRefT *, MappedRefT *>)
+        AbstractFlatHashMapIterator(
+            const AbstractFlatHashMapIterator<OtherKeyRefT, OtherMappedRefT> &other)
+            : mp_occupancy(other.mp_occupancy), mp_key(other.mp_key), mp_value(other.mp_value),
+              m_index(other.m_index), m_capacity(other.m_capacity)
+        {}
+
+        AbstractFlatHashMapIterator &operator=(const AbstractFlatHashMapIterator &other) = default;
+        AbstractFlatHashMapIterator &operator=(AbstractFlatHashMapIterator &&other) = default;
+
+        auto operator++()
+        {
+            ++m_index;
+            skipEmpty();
+            return *this;
+        }
+
+        auto operator++(int)
+        {
+            auto tmp = *this;
+            ++(*this);
+            return tmp;
+        }
+
+        bool operator==(const AbstractFlatHashMapIterator &other) const
+        {
+            return m_index == other.m_index;
+        }
+
+        auto operator*() const { return value_type(mp_key[m_index], mp_value[m_index]); }
+    };
+
+  public:
+    using FlatHashMapIterator = AbstractFlatHashMapIterator<const KeyT, MappedT>;
+    using CFlatHashMapIterator = AbstractFlatHashMapIterator<const KeyT, const MappedT>;
+
+    using key_type = KeyT;
+    using mapped_type = MappedT;
+    using value_type = FlatHashMapIterator::value_type;
+    using const_value_type = CFlatHashMapIterator::value_type;
+
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    using reference = FlatHashMapIterator::reference;
+    using const_reference = CFlatHashMapIterator::reference;
+    using iterator = FlatHashMapIterator;
+    using const_iterator = CFlatHashMapIterator;
+
+    FlatHashMap()
+        : mp_resource(std::pmr::get_default_resource()), m_data(nullptr), m_size(0), m_capacity(0)
+    {}
+
+    explicit FlatHashMap(std::pmr::memory_resource *p_resource)
+        : mp_resource(p_resource), m_data(nullptr), m_size(0), m_capacity(0)
+    {}
+
+    FlatHashMap(const FlatHashMap &o)
+        : mp_resource(std::pmr::get_default_resource()), m_data(nullptr), m_size(0), m_capacity(0)
+    {
+        copyFrom(o);
+    }
+
+    FlatHashMap(FlatHashMap &&o)
+        : mp_resource(o.mp_resource), m_data(o.m_data), m_size(o.m_size), m_capacity(o.m_capacity)
+    {
+        o.m_data = nullptr;
+        o.m_size = 0;
+        o.m_capacity = 0;
+    }
+
+    FlatHashMap(std::initializer_list<std::pair<KeyT, MappedT>> initList)
+        : mp_resource(std::pmr::get_default_resource()), m_data(nullptr), m_size(0), m_capacity(0)
+    {
+        reserve(initList.size());
+        for (const auto &keyVal : initList) {
+            emplace(keyVal.first, keyVal.second);
+        }
+    }
+
+    ~FlatHashMap()
+    {
+        destroyAll();
+        deallocateBuffer(m_data, m_capacity);
+    }
+
+    FlatHashMap &operator=(const FlatHashMap &o)
+    {
+        if (this != &o) {
+            destroyAll();
+            deallocateBuffer(m_data, m_capacity);
+            m_data = nullptr;
+            m_size = 0;
+            m_capacity = 0;
+
+            copyFrom(o);
+        }
+        return *this;
+    }
+
+    FlatHashMap &operator=(FlatHashMap &&o)
+    {
+        if (this != &o) {
+            destroyAll();
+
+            if (*mp_resource == *o.mp_resource) {
+                deallocateBuffer(m_data, m_capacity);
+
+                m_data = o.m_data;
+                m_size = o.m_size;
+                m_capacity = o.m_capacity;
+                o.m_data = nullptr;
+                o.m_size = 0;
+                o.m_capacity = 0;
+            } else {
+                // the buffer can't change owners, so move the elements instead
+                m_size = 0;
+                reserve(o.m_size);
+                for (std::size_t i = 0; i < o.m_capacity; ++i) {
+                    if (o.getOccupancyList()[i]) {
+                        emplace(o.getKeyList()[i], std::move(o.getValueList()[i]));
+                    }
+                }
+                o.clear();
+            }
+        }
+        return *this;
+    }
+
+    std::pmr::memory_resource *getMemoryResource() const { return mp_resource; }
+
+    std::size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    std::size_t capacity() const { return m_capacity; }
+
+    FlatHashMapIterator begin()
+    {
+        return FlatHashMapIterator(getOccupancyList(), getKeyList(), getValueList(), 0,
+                                   m_capacity);
+    }
+    FlatHashMapIterator end()
+    {
+        return FlatHashMapIterator(getOccupancyList(), getKeyList(), getValueList(), m_capacity,
+                                   m_capacity);
+    }
+    CFlatHashMapIterator begin() const { return cbegin(); }
+    CFlatHashMapIterator end() const { return cend(); }
+    CFlatHashMapIterator cbegin() const
+    {
+        return CFlatHashMapIterator(getOccupancyList(), getKeyList(), getValueList(), 0,
+                                    m_capacity);
+    }
+    CFlatHashMapIterator cend() const
+    {
+        return CFlatHashMapIterator(getOccupancyList(), getKeyList(), getValueList(), m_capacity,
+                                    m_capacity);
+    }
+
+    FlatHashMapIterator find(const KeyT &key)
+    {
+        std::size_t ind = findIndex(key);
+        return FlatHashMapIterator(getOccupancyList(), getKeyList(), getValueList(), ind,
+                                   m_capacity);
+    }
+
+    CFlatHashMapIterator find(const KeyT &key) const
+    {
+        std::size_t ind = findIndex(key);
+        return CFlatHashMapIterator(getOccupancyList(), getKeyList(), getValueList(), ind,
+                                    m_capacity);
+    }
+
+    bool contains(const KeyT &key) const { return findIndex(key) != m_capacity; }
+    std::size_t count(const KeyT &key) const { return contains(key) ? 1 : 0; }
+
+    MappedT &operator[](const KeyT &key) { return (*emplace(key).first).second; }
+    const MappedT &operator[](const KeyT &key) const { return at(key); }
+
+    MappedT &at(const KeyT &key)
+    {
+        std::size_t ind = findIndex(key);
+        if (ind != m_capacity) {
+            return getValueList()[ind];
+        }
+        throw std::out_of_range("Key not found");
+    }
+
+    const MappedT &at(const KeyT &key) const
+    {
+        std::size_t ind = findIndex(key);
+        if (ind != m_capacity) {
+            return getValueList()[ind];
+        }
+        throw std::out_of_range("Key not found");
+    }
+
+    template <class... Args> std::pair<iterator, bool> emplace(const KeyT &key, Args &&...args)
+    {
+        std::size_t ind = findIndex(key);
+        if (ind != m_capacity) {
+            return std::make_pair(iteratorAt(ind), false);
+        }
+
+        if ((m_size + 1) * MAX_LOAD_DENOMINATOR > m_capacity * MAX_LOAD_NUMERATOR) {
+            rehash(m_capacity == 0 ? MIN_CAPACITY : m_capacity * 2);
+        }
+
+        ind = findFreeIndex(key);
+        new (getKeyList() + ind) KeyT(key);
+        new (getValueList() + ind) MappedT(std::forward<Args>(args)...);
+        getOccupancyList()[ind] = 1;
+        ++m_size;
+
+        return std::make_pair(iteratorAt(ind), true);
+    }
+
+    std::pair<iterator, bool> insert(const std::pair<const KeyT, MappedT> &value)
+    {
+        return emplace(value.first, value.second);
+    }
+
+    std::pair<iterator, bool> insert(std::pair<const KeyT &, MappedT &> value)
+    {
+        return emplace(value.first, value.second);
+    }
+
+    std::size_t erase(const KeyT &key)
+    {
+        std::size_t ind = findIndex(key);
+        if (ind != m_capacity) {
+            eraseAt(ind);
+            return 1;
+        }
+        return 0;
+    }
+
+    std::size_t erase(CFlatHashMapIterator pos)
+    {
+        assert(pos.m_index < m_capacity && getOccupancyList()[pos.m_index]);
+        eraseAt(pos.m_index);
+        return 1;
+    }
+
+    /**
+     * Ensures that numElements can be stored without rehashing
+     */
+    void reserve(std::size_t numElements)
+    {
+        std::size_t newCapacity = m_capacity == 0 ? MIN_CAPACITY : m_capacity;
+        while (numElements * MAX_LOAD_DENOMINATOR > newCapacity * MAX_LOAD_NUMERATOR) {
+            newCapacity *= 2;
+        }
+        if (newCapacity != m_capacity) {
+            rehash(newCapacity);
+        }
+    }
+
+    /**
+     * Destroys all elements, but keeps the allocated slots for reuse
+     */
+    void clear()
+    {
+        destroyAll();
+        m_size = 0;
+    }
+
+  protected:
+    static constexpr std::size_t MIN_CAPACITY = 8;
+    static constexpr std::size_t MAX_LOAD_NUMERATOR = 3;
+    static constexpr std::size_t MAX_LOAD_DENOMINATOR = 4;
+
+    static_assert(alignof(KeyT) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__ &&
+                      alignof(MappedT) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+                  "FlatHashMap doesn't support over-aligned types");
+
+    std::pmr::memory_resource *mp_resource;
+    std::byte *m_data; // starts with occupancy flags, then keys, then values. Owned by the map
+    std::size_t m_size;
+    std::size_t m_capacity; // always 0 or a power of 2
+
+    static constexpr std::size_t alignedOffset(std::size_t offset, std::size_t alignment)
+    {
+        return (offset + alignment - 1) / alignment * alignment;
+    }
+
+    static constexpr std::size_t getKeyBufferOffset(std::size_t numSlots)
+    {
+        return alignedOffset(numSlots * sizeof(std::uint8_t), alignof(KeyT));
+    }
+
+    static constexpr std::size_t getValueBufferOffset(std::size_t numSlots)
+    {
+        return alignedOffset(getKeyBufferOffset(numSlots) + numSlots * sizeof(KeyT),
+                             alignof(MappedT));
+    }
+
+    static constexpr std::size_t getBufferSize(std::size_t numSlots)
+    {
+        return getValueBufferOffset(numSlots) + numSlots * sizeof(MappedT);
+    }
+
+    std::byte *allocateBuffer(std::size_t numSlots)
+    {
+        return static_cast<std::byte *>(
+            mp_resource->allocate(getBufferSize(numSlots), __STDCPP_DEFAULT_NEW_ALIGNMENT__));
+    }
+
+    void deallocateBuffer(std::byte *data, std::size_t numSlots)
+    {
+        if (data != nullptr) {
+            mp_resource->deallocate(data, getBufferSize(numSlots),
+                                    __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+        }
+    }
+
+    std::uint8_t *getOccupancyList() { return reinterpret_cast<std::uint8_t *>(m_data); }
+    const std::uint8_t *getOccupancyList() const
+    {
+        return reinterpret_cast<const std::uint8_t *>(m_data);
+    }
+    KeyT *getKeyList() { return reinterpret_cast<KeyT *>(m_data + getKeyBufferOffset(m_capacity)); }
+    const KeyT *getKeyList() const
+    {
+        return reinterpret_cast<const KeyT *>(m_data + getKeyBufferOffset(m_capacity));
+    }
+    MappedT *getValueList()
+    {
+        return reinterpret_cast<MappedT *>(m_data + getValueBufferOffset(m_capacity));
+    }
+    const MappedT *getValueList() const
+    {
+        return reinterpret_cast<const MappedT *>(m_data + getValueBufferOffset(m_capacity));
+    }
+
+    FlatHashMapIterator iteratorAt(std::size_t ind)
+    {
+        return FlatHashMapIterator(getOccupancyList(), getKeyList(), getValueList(), ind,
+                                   m_capacity);
+    }
+
+    /**
+     * @returns The preferred slot of the key
+     */
+    std::size_t homeIndex(const KeyT &key) const
+    {
+        // fibonacci hashing; uses the high bits which are well mixed for any reasonable hash
+        std::uint64_t h = static_cast<std::uint64_t>(HashT{}(key)) * 0x9E3779B97F4A7C15ULL;
+        return static_cast<std::size_t>(h >> 32) & (m_capacity - 1);
+    }
+
+    /**
+     * @returns The slot index of the key, or m_capacity if not found
+     */
+    std::size_t findIndex(const KeyT &key) const
+    {
+        if (m_size == 0) {
+            return m_capacity;
+        }
+
+        const std::uint8_t *occupancy = getOccupancyList();
+        const KeyT *keyList = getKeyList();
+        std::size_t mask = m_capacity - 1;
+
+        for (std::size_t ind = homeIndex(key);; ind = (ind + 1) & mask) {
+            if (!occupancy[ind]) {
+                return m_capacity;
+            }
+            if (keyList[ind] == key) {
+                return ind;
+            }
+        }
+    }
+
+    /**
+     * @returns The first free slot in the probe sequence of the key
+     * @note The map must have at least one free slot
+     */
+    std::size_t findFreeIndex(const KeyT &key) const
+    {
+        const std::uint8_t *occupancy = getOccupancyList();
+        std::size_t mask = m_capacity - 1;
+
+        std::size_t ind = homeIndex(key);
+        while (occupancy[ind]) {
+            ind = (ind + 1) & mask;
+        }
+        return ind;
+    }
+
+    void eraseAt(std::size_t ind)
+    {
+        std::uint8_t *occupancy = getOccupancyList();
+        KeyT *keyList = getKeyList();
+        MappedT *valueList = getValueList();
+        std::size_t mask = m_capacity - 1;
+
+        keyList[ind].~KeyT();
+        valueList[ind].~MappedT();
+        occupancy[ind] = 0;
+        --m_size;
+
+        // backward shift deletion; keeps probe sequences unbroken without tombstones
+        std::size_t holeInd = ind;
+        for (std::size_t nextInd = (ind + 1) & mask; occupancy[nextInd];
+             nextInd = (nextInd + 1) & mask) {
+            std::size_t home = homeIndex(keyList[nextInd]);
+
+            // can the element at nextInd be moved to the hole? (is hole within [home, nextInd))
+            if (((nextInd - home) & mask) >= ((nextInd - holeInd) & mask)) {
+                new (keyList + holeInd) KeyT(std::move(keyList[nextInd]));
+                new (valueList + holeInd) MappedT(std::move(valueList[nextInd]));
+                keyList[nextInd].~KeyT();
+                valueList[nextInd].~MappedT();
+                occupancy[holeInd] = 1;
+                occupancy[nextInd] = 0;
+                holeInd = nextInd;
+            }
+        }
+    }
+
+    void rehash(std::size_t newCapacity)
+    {
+        std::byte *oldData = m_data;
+        std::size_t oldCapacity = m_capacity;
+        std::uint8_t *oldOccupancy = getOccupancyList();
+        KeyT *oldKeyList = getKeyList();
+        MappedT *oldValueList = getValueList();
+
+        m_data = allocateBuffer(newCapacity);
+        m_capacity = newCapacity;
+
+        std::uint8_t *occupancy = getOccupancyList();
+        KeyT *keyList = getKeyList();
+        MappedT *valueList = getValueList();
+        std::fill(occupancy, occupancy + m_capacity, std::uint8_t(0));
+
+        for (std::size_t i = 0; i < oldCapacity; ++i) {
+            if (oldOccupancy[i]) {
+                std::size_t ind = findFreeIndex(oldKeyList[i]);
+                new (keyList + ind) KeyT(std::move(oldKeyList[i]));
+                new (valueList + ind) MappedT(std::move(oldValueList[i]));
+                occupancy[ind] = 1;
+                oldKeyList[i].~KeyT();
+                oldValueList[i].~MappedT();
+            }
+        }
+
+        deallocateBuffer(oldData, oldCapacity);
+    }
+
+    void copyFrom(const FlatHashMap &o)
+    {
+        if (o.m_capacity == 0) {
+            return;
+        }
+
+        m_data = allocateBuffer(o.m_capacity);
+        m_capacity = o.m_capacity;
+        m_size = o.m_size;
+
+        std::uint8_t *occupancy = getOccupancyList();
+        std::copy(o.getOccupancyList(), o.getOccupancyList() + m_capacity, occupancy);
+        for (std::size_t i = 0; i < m_capacity; ++i) {
+            if (occupancy[i]) {
+                new (getKeyList() + i) KeyT(o.getKeyList()[i]);
+                new (getValueList() + i) MappedT(o.getValueList()[i]);
+            }
+        }
+    }
+
+    void destroyAll()
+    {
+        if (m_size == 0) {
+            return;
+        }
+
+        std::uint8_t *occupancy = getOccupancyList();
+        for (std::size_t i = 0; i < m_capacity; ++i) {
+            if (occupancy[i]) {
+                getKeyList()[i].~KeyT();
+                getValueList()[i].~MappedT();
+                occupancy[i] = 0;
+            }
+        }
+    }
+};
+
+} // namespace Vitrae
\ No newline at end of file
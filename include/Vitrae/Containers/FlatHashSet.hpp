@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Vitrae/Containers/FlatHashMap.hpp"
+
+namespace Vitrae
+{
+
+/**
+ * @brief A set counterpart of the FlatHashMap, with the same layout and invalidation rules
+ * @note Meant for lookups of visited keys; it isn't iterable
+ *
+ * @tparam KeyT the type of the key
+ * @tparam HashT the hashing functor type
+ */
+template <class KeyT, class HashT = std::hash<KeyT>> class FlatHashSet
+{
+    struct Empty
+    {};
+
+    FlatHashMap<KeyT, Empty, HashT> m_map;
+
+  public:
+    FlatHashSet() = default;
+    explicit FlatHashSet(std::pmr::memory_resource *p_resource) : m_map(p_resource) {}
+
+    std::size_t size() const { return m_map.size(); }
+    bool empty() const { return m_map.empty(); }
+
+    bool contains(const KeyT &key) const { return m_map.contains(key); }
+
+    /**
+     * @returns Whether the key was inserted, i.e. it wasn't in the set already
+     */
+    bool insert(const KeyT &key) { return m_map.emplace(key).second; }
+
+    std::size_t erase(const KeyT &key) { return m_map.erase(key); }
+
+    /**
+     * Ensures that numElements can be stored without rehashing
+     */
+    void reserve(std::size_t numElements) { m_map.reserve(numElements); }
+
+    void clear() { m_map.clear(); }
+};
+
+} // namespace Vitrae
\ No newline at end of file
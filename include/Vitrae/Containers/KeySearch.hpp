@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Vitrae/Util/PackedKeyTraits.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace Vitrae
+{
+
+/**
+ * The maximum map size for which the linear packed search is used instead of a binary search.
+ * For larger maps the logarithmic number of comparisons wins over the linear scan
+ */
+#if defined(__AVX2__)
+inline constexpr std::size_t PACKED_LINEAR_SEARCH_MAX_SIZE = 64;
+#else
+inline constexpr std::size_t PACKED_LINEAR_SEARCH_MAX_SIZE = 32;
+#endif
+
+/**
+ * @returns The index of the first key not less than the key, in a sorted array of packed keys
+ * @note Uses AVX2 if the compiler targets it, otherwise a branchless scalar loop
+ */
+template <PackedKey KeyT>
+inline std::size_t lowerBoundPacked(const KeyT *keys, std::size_t count, const KeyT &key)
+{
+    const std::uint64_t packedKey = PackedKeyTraits<KeyT>::toPacked(key);
+
+    std::size_t ind = 0;
+    std::size_t less = 0;
+
+#if defined(__AVX2__)
+    // cmpgt is signed, so flip the sign bits to get the unsigned ordering.
+    // The unaligned load intrinsic may alias any type
+    constexpr std::uint64_t signBit = 0x8000000000000000ULL;
+    const __m256i biasVec = _mm256_set1_epi64x(signBit);
+    const __m256i keyVec = _mm256_set1_epi64x(packedKey ^ signBit);
+    for (; ind + 4 <= count; ind += 4) {
+        __m256i data = _mm256_xor_si256(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys + ind)), biasVec);
+        __m256i isLess = _mm256_cmpgt_epi64(keyVec, data);
+        less += std::popcount(
+            static_cast<unsigned int>(_mm256_movemask_pd(_mm256_castsi256_pd(isLess))));
+    }
+#endif
+
+    for (; ind < count; ++ind) {
+        less += PackedKeyTraits<KeyT>::toPacked(keys[ind]) < packedKey;
+    }
+
+    return less;
+}
+
+} // namespace Vitrae
\ No newline at end of file
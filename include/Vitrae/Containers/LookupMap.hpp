@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Vitrae/Containers/FlatHashMap.hpp"
+#include "Vitrae/Containers/StableMap.hpp"
+
+namespace Vitrae
+{
+
+/**
+ * @brief Describes how a keyed container is laid out, chosen at compile time per container
+ */
+enum class LookupPolicy {
+    Sorted, // StableMap; ordered iteration, fast lookup, slow modification of keys
+    Hashed, // FlatHashMap; unordered iteration, fast lookup and amortized O(1) insertion
+};
+
+template <class KeyT, class MappedT, LookupPolicy Policy> struct LookupMapSelector;
+
+template <class KeyT, class MappedT> struct LookupMapSelector<KeyT, MappedT, LookupPolicy::Sorted>
+{
+    using type = StableMap<KeyT, MappedT>;
+};
+
+template <class KeyT, class MappedT> struct LookupMapSelector<KeyT, MappedT, LookupPolicy::Hashed>
+{
+    using type = FlatHashMap<KeyT, MappedT>;
+};
+
+/**
+ * A map type selected by the policy.
+ * Use LookupPolicy::Hashed for containers that get modified often (like per-frame property
+ * scopes), and LookupPolicy::Sorted where the iteration order matters
+ */
+template <class KeyT, class MappedT, LookupPolicy Policy>
+using LookupMap = typename LookupMapSelector<KeyT, MappedT, Policy>::type;
+
+} // namespace Vitrae
\ No newline at end of file
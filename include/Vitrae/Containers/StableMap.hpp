@@ -1,8 +1,11 @@
 #pragma once
 
+#include "Vitrae/Containers/KeySearch.hpp"
+
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <iterator>
 #include <map>
 #include <span>
 #include <stdexcept>
@@ -167,52 +170,36 @@ template <class KeyT, class MappedT> class StableMap
     using iterator = StableMapIterator;
     using const_iterator = CStableMapIterator;
 
-    StableMap() : m_data(nullptr), m_size(0) {};
+    StableMap() : m_size(0), m_capacity(0), m_data(nullptr) {};
 
     StableMap(const StableMap &o)
     {
         m_size = o.m_size;
-        m_data = new std::byte[getBufferSize(m_size)];
-        ;
+        m_capacity = o.m_size;
+        m_data = new std::byte[getBufferSize(m_capacity)];
+
         for (std::size_t i = 0; i < m_size; ++i) {
             new (getKeyList() + i) KeyT(o.getKeyList()[i]);
             new (getValueList() + i) MappedT(o.getValueList()[i]);
         }
     }
 
-    StableMap(StableMap &&o) : m_data(o.m_data), m_size(o.m_size)
+    StableMap(StableMap &&o) : m_size(o.m_size), m_capacity(o.m_capacity), m_data(o.m_data)
     {
         o.m_size = 0;
+        o.m_capacity = 0;
         o.m_data = nullptr;
     }
 
-    template <class InputItT>
+    template <std::forward_iterator InputItT>
     StableMap(InputItT first, InputItT last)
         requires requires(InputItT it) {
             { (*it).first } -> std::convertible_to<KeyT>;
             { (*it).second } -> std::convertible_to<MappedT>;
         }
+        : StableMap()
     {
-        std::size_t i;
-        m_size = std::distance(first, last);
-        m_data = new std::byte[getBufferSize(m_size)];
-
-        std::vector<InputItT> sortedIterators;
-        sortedIterators.reserve(m_size);
-        i = 0;
-        for (auto it = first; it != last; ++it) {
-            sortedIterators.emplace_back(it);
-            ++i;
-        }
-        std::sort(sortedIterators.begin(), sortedIterators.end(),
-                  [&](auto a, auto b) { return (*a).first < (*b).first; });
-
-        i = 0;
-        for (auto it : sortedIterators) {
-            new (getKeyList() + i) KeyT(it->first);
-            new (getValueList() + i) MappedT(it->second);
-            ++i;
-        }
+        insert_range(first, last);
     }
 
     StableMap(std::initializer_list<std::pair<KeyT, MappedT>> initList)
@@ -224,7 +211,8 @@ template <class KeyT, class MappedT> class StableMap
         requires std::convertible_to<OKeyT, KeyT> && std::convertible_to<OMappedT, MappedT>
     {
         m_size = orderedList.size();
-        m_data = new std::byte[getBufferSize(m_size)];
+        m_capacity = m_size;
+        m_data = new std::byte[getBufferSize(m_capacity)];
 
         int i = 0;
         for (const auto &keyVal : orderedList) {
@@ -239,7 +227,8 @@ template <class KeyT, class MappedT> class StableMap
         requires std::convertible_to<OKeyT, KeyT> && std::convertible_to<OMappedT, MappedT>
     {
         m_size = orderedList.size();
-        m_data = new std::byte[getBufferSize(m_size)];
+        m_capacity = m_size;
+        m_data = new std::byte[getBufferSize(m_capacity)];
 
         int i = 0;
         for (auto &keyVal : orderedList) {
@@ -266,9 +255,12 @@ template <class KeyT, class MappedT> class StableMap
                 getValueList()[i].~MappedT();
             }
 
-            delete[] m_data;
+            if (m_capacity < o.m_size) {
+                delete[] m_data;
+                m_capacity = o.m_size;
+                m_data = new std::byte[getBufferSize(m_capacity)];
+            }
             m_size = o.m_size;
-            m_data = new std::byte[getBufferSize(m_size)];
 
             for (std::size_t i = 0; i < m_size; ++i) {
                 new (getKeyList() + i) KeyT(o.getKeyList()[i]);
@@ -287,14 +279,17 @@ template <class KeyT, class MappedT> class StableMap
 
             delete[] m_data;
             m_size = o.m_size;
+            m_capacity = o.m_capacity;
             m_data = o.m_data;
             o.m_size = 0;
+            o.m_capacity = 0;
             o.m_data = nullptr;
         }
         return *this;
     }
 
     std::size_t size() const { return m_size; }
+    std::size_t capacity() const { return m_capacity; }
     std::span<const KeyT> keys() const { return std::span<const KeyT>(getKeyList(), m_size); }
     std::span<MappedT> values() { return std::span<MappedT>(getValueList(), m_size); }
     std::span<const MappedT> values() const
@@ -454,7 +449,7 @@ template <class KeyT, class MappedT> class StableMap
             ind = 0;
         }
 
-        realloc_w_uninit(ind);
+        shift_w_uninit(ind);
         new (getKeyList() + ind) KeyT(key);
         new (getValueList() + ind) MappedT();
         return getValueList()[ind];
@@ -495,7 +490,7 @@ template <class KeyT, class MappedT> class StableMap
             ind = 0;
         }
 
-        realloc_w_uninit(ind);
+        shift_w_uninit(ind);
         new (getKeyList() + ind) KeyT(key);
         new (getValueList() + ind) MappedT(std::forward<Args>(args)...);
         return std::make_pair(iterator(getKeyList() + ind, getValueList() + ind), true);
@@ -516,7 +511,7 @@ template <class KeyT, class MappedT> class StableMap
         if (m_size > 0) {
             std::size_t ind = findClosestIndex(key);
             if (ind < m_size && !(key < getKeyList()[ind])) {
-                realloc_w_erased(ind);
+                shift_w_erased(ind);
                 return 1;
             }
         }
@@ -528,7 +523,7 @@ template <class KeyT, class MappedT> class StableMap
     {
         std::size_t ind = pos.mp_key - getKeyList();
         assert(ind < m_size);
-        realloc_w_erased(ind);
+        shift_w_erased(ind);
         return 1;
     }
 
@@ -539,13 +534,87 @@ template <class KeyT, class MappedT> class StableMap
             getValueList()[i].~MappedT();
         }
         m_size = 0;
+        m_capacity = 0;
         delete[] m_data;
         m_data = nullptr;
     }
 
+    /**
+     * Ensures that numElements can be stored without reallocating
+     */
+    void reserve(std::size_t numElements)
+    {
+        if (numElements > m_capacity) {
+            reallocate(numElements);
+        }
+    }
+
+    /**
+     * Frees the unused capacity
+     */
+    void shrink_to_fit()
+    {
+        if (m_size < m_capacity) {
+            reallocate(m_size);
+        }
+    }
+
+    /**
+     * Inserts all elements from the range whose keys aren't already in the map.
+     * Sorts the range once and merges it in a single pass,
+     * instead of shifting the elements for each inserted key
+     * @note If the range contains repeated keys, the first occurrence is inserted
+     * @note Requires forward iterators, since the iterators are kept and dereferenced again
+     */
+    template <std::forward_iterator InputItT>
+    void insert_range(InputItT first, InputItT last)
+        requires requires(InputItT it) {
+            { (*it).first } -> std::convertible_to<KeyT>;
+            { (*it).second } -> std::convertible_to<MappedT>;
+        }
+    {
+        std::vector<InputItT> sortedIterators;
+        for (auto it = first; it != last; ++it) {
+            sortedIterators.emplace_back(it);
+        }
+        std::stable_sort(sortedIterators.begin(), sortedIterators.end(),
+                         [&](auto a, auto b) { return KeyT((*a).first) < KeyT((*b).first); });
+        sortedIterators.erase(
+            std::unique(sortedIterators.begin(), sortedIterators.end(),
+                        [&](auto a, auto b) { return !(KeyT((*a).first) < KeyT((*b).first)); }),
+            sortedIterators.end());
+
+        mergeSortedIncoming(sortedIterators.size(),
+                            [&](std::size_t j) -> decltype(auto) { return *sortedIterators[j]; });
+    }
+
+    /**
+     * Inserts all elements from the range whose keys aren't already in the map,
+     * in a single pass
+     * @note The range has to be sorted by keys, without repeated keys. It is traversed more than
+     * once, so random access iterators are required
+     */
+    template <std::random_access_iterator InputItT>
+    void merge_sorted(InputItT first, InputItT last)
+        requires requires(InputItT it) {
+            { (*it).first } -> std::convertible_to<KeyT>;
+            { (*it).second } -> std::convertible_to<MappedT>;
+        }
+    {
+        assert(std::is_sorted(first, last, [](const auto &a, const auto &b) {
+            return KeyT(a.first) < KeyT(b.first);
+        }));
+
+        mergeSortedIncoming(last - first,
+                            [&](std::size_t j) -> decltype(auto) { return first[j]; });
+    }
+
   protected:
+    static constexpr std::size_t MIN_GROWTH_CAPACITY = 4;
+
     std::size_t m_size;
-    std::byte *m_data; // starts with keys, also contains values. Owned by the map
+    std::size_t m_capacity; // number of elements that fit into m_data
+    std::byte *m_data;      // starts with keys, also contains values. Owned by the map
 
     static constexpr std::size_t getValueBufferOffset(std::size_t numElements)
     {
@@ -568,8 +637,17 @@ template <class KeyT, class MappedT> class StableMap
     std::size_t findClosestIndex(const KeyT &key, std::size_t leftIndex, std::size_t rightIndex,
                                  std::size_t midIndex) const
     {
-        // uses binary search to find the index of the closest key
         const KeyT *keyList = getKeyList();
+
+        // small ranges of packed keys are scanned linearly with vectorized comparisons,
+        // which avoids the unpredictable branches of the binary search
+        if constexpr (PackedKey<KeyT>) {
+            if (leftIndex <= rightIndex && rightIndex - leftIndex <= PACKED_LINEAR_SEARCH_MAX_SIZE) {
+                return leftIndex + lowerBoundPacked(keyList + leftIndex, rightIndex - leftIndex, key);
+            }
+        }
+
+        // uses binary search to find the index of the closest key
         if (leftIndex < rightIndex) {
             if (keyList[midIndex] < key) {
                 leftIndex = midIndex + 1;
@@ -593,73 +671,175 @@ template <class KeyT, class MappedT> class StableMap
     const KeyT *getKeyList() const { return reinterpret_cast<const KeyT *>(m_data); }
     MappedT *getValueList()
     {
-        return reinterpret_cast<MappedT *>(m_data + getValueBufferOffset(m_size));
+        return reinterpret_cast<MappedT *>(m_data + getValueBufferOffset(m_capacity));
     }
     const MappedT *getValueList() const
     {
-        return reinterpret_cast<const MappedT *>(m_data + getValueBufferOffset(m_size));
+        return reinterpret_cast<const MappedT *>(m_data + getValueBufferOffset(m_capacity));
     }
 
-    void realloc_w_erased(difference_type erasingIndex)
+    /**
+     * Moves all elements into a new buffer with the specified capacity
+     */
+    void reallocate(std::size_t newCapacity)
     {
-        std::byte *newData = new std::byte[getBufferSize(m_size - 1)];
+        assert(newCapacity >= m_size);
+
+        std::byte *newData = new std::byte[getBufferSize(newCapacity)];
         KeyT *newKeyList = reinterpret_cast<KeyT *>(newData);
         MappedT *newValueList =
-            reinterpret_cast<MappedT *>(newData + getValueBufferOffset(m_size - 1));
+            reinterpret_cast<MappedT *>(newData + getValueBufferOffset(newCapacity));
 
-        // move data before
-        for (std::size_t i = 0; i < erasingIndex; ++i) {
+        for (std::size_t i = 0; i < m_size; ++i) {
             new (newKeyList + i) KeyT(std::move(getKeyList()[i]));
             new (newValueList + i) MappedT(std::move(getValueList()[i]));
             getKeyList()[i].~KeyT();
             getValueList()[i].~MappedT();
         }
 
+        delete[] m_data;
+        m_data = newData;
+        m_capacity = newCapacity;
+    }
+
+    /**
+     * @returns the capacity to grow to when the buffer is full
+     */
+    std::size_t grownCapacity(std::size_t minCapacity) const
+    {
+        return std::max({minCapacity, m_capacity * 2, MIN_GROWTH_CAPACITY});
+    }
+
+    /**
+     * Destroys the element at erasingIndex, and shifts the following elements to fill the gap
+     */
+    void shift_w_erased(std::size_t erasingIndex)
+    {
+        KeyT *keyList = getKeyList();
+        MappedT *valueList = getValueList();
+
         // erase
-        getKeyList()[erasingIndex].~KeyT();
-        getValueList()[erasingIndex].~MappedT();
+        keyList[erasingIndex].~KeyT();
+        valueList[erasingIndex].~MappedT();
 
         // move data after
         for (std::size_t i = erasingIndex + 1; i < m_size; ++i) {
-            new (newKeyList + i - 1) KeyT(std::move(getKeyList()[i]));
-            new (newValueList + i - 1) MappedT(std::move(getValueList()[i]));
-            getKeyList()[i].~KeyT();
-            getValueList()[i].~MappedT();
+            new (keyList + i - 1) KeyT(std::move(keyList[i]));
+            new (valueList + i - 1) MappedT(std::move(valueList[i]));
+            keyList[i].~KeyT();
+            valueList[i].~MappedT();
         }
 
-        delete[] m_data;
-        m_data = newData;
         --m_size;
     }
 
-    void realloc_w_uninit(difference_type uninitIndex)
+    /**
+     * Leaves the element at uninitIndex uninitialized, shifting the following elements.
+     * Grows the buffer geometrically if there is no room
+     */
+    void shift_w_uninit(std::size_t uninitIndex)
     {
-        std::size_t newBufferSize = getBufferSize(m_size + 1);
-        std::byte *newData = new std::byte[newBufferSize];
-        KeyT *newKeyList = reinterpret_cast<KeyT *>(newData);
-        MappedT *newValueList =
-            reinterpret_cast<MappedT *>(newData + getValueBufferOffset(m_size + 1));
+        if (m_size == m_capacity) {
+            std::size_t newCapacity = grownCapacity(m_size + 1);
+            std::byte *newData = new std::byte[getBufferSize(newCapacity)];
+            KeyT *newKeyList = reinterpret_cast<KeyT *>(newData);
+            MappedT *newValueList =
+                reinterpret_cast<MappedT *>(newData + getValueBufferOffset(newCapacity));
 
-        // move data before
-        for (std::size_t i = 0; i < uninitIndex; ++i) {
-            new (newKeyList + i) KeyT(std::move(getKeyList()[i]));
-            new (newValueList + i) MappedT(std::move(getValueList()[i]));
-            getKeyList()[i].~KeyT();
-            getValueList()[i].~MappedT();
-        }
+            // move data before
+            for (std::size_t i = 0; i < uninitIndex; ++i) {
+                new (newKeyList + i) KeyT(std::move(getKeyList()[i]));
+                new (newValueList + i) MappedT(std::move(getValueList()[i]));
+                getKeyList()[i].~KeyT();
+                getValueList()[i].~MappedT();
+            }
 
-        // move data after
-        for (std::size_t i = uninitIndex; i < m_size; ++i) {
-            new (newKeyList + i + 1) KeyT(std::move(getKeyList()[i]));
-            new (newValueList + i + 1) MappedT(std::move(getValueList()[i]));
-            getKeyList()[i].~KeyT();
-            getValueList()[i].~MappedT();
+            // move data after
+            for (std::size_t i = uninitIndex; i < m_size; ++i) {
+                new (newKeyList + i + 1) KeyT(std::move(getKeyList()[i]));
+                new (newValueList + i + 1) MappedT(std::move(getValueList()[i]));
+                getKeyList()[i].~KeyT();
+                getValueList()[i].~MappedT();
+            }
+
+            delete[] m_data;
+            m_data = newData;
+            m_capacity = newCapacity;
+        } else {
+            KeyT *keyList = getKeyList();
+            MappedT *valueList = getValueList();
+
+            // move data after, starting from the back
+            for (std::size_t i = m_size; i > uninitIndex; --i) {
+                new (keyList + i) KeyT(std::move(keyList[i - 1]));
+                new (valueList + i) MappedT(std::move(valueList[i - 1]));
+                keyList[i - 1].~KeyT();
+                valueList[i - 1].~MappedT();
+            }
         }
 
-        delete[] m_data;
-        m_data = newData;
         ++m_size;
     }
+
+    /**
+     * Merges sorted elements with unique keys into the map in a single pass.
+     * Existing keys keep their values
+     * @param incomingCount The number of incoming elements
+     * @param getIncoming A function returning the j-th pair-like incoming element
+     */
+    template <class IncomingGetterT>
+    void mergeSortedIncoming(std::size_t incomingCount, IncomingGetterT getIncoming)
+    {
+        // count the keys that aren't in the map already
+        std::size_t newCount = 0;
+        for (std::size_t i = 0, j = 0; j < incomingCount; ++j) {
+            auto &&incoming = getIncoming(j);
+            KeyT key(incoming.first);
+            while (i < m_size && getKeyList()[i] < key) {
+                ++i;
+            }
+            if (i == m_size || key < getKeyList()[i]) {
+                ++newCount;
+            }
+        }
+
+        if (newCount == 0) {
+            return;
+        }
+
+        std::size_t newSize = m_size + newCount;
+        if (newSize > m_capacity) {
+            reallocate(grownCapacity(newSize));
+        }
+
+        // merge from the back, so every element is moved at most once
+        KeyT *keyList = getKeyList();
+        MappedT *valueList = getValueList();
+        std::size_t i = m_size, j = incomingCount, w = newSize;
+        while (w > i) {
+            auto &&incoming = getIncoming(j - 1);
+            KeyT incomingKey(incoming.first);
+
+            if (i > 0 && incomingKey < keyList[i - 1]) {
+                --i;
+                --w;
+                new (keyList + w) KeyT(std::move(keyList[i]));
+                new (valueList + w) MappedT(std::move(valueList[i]));
+                keyList[i].~KeyT();
+                valueList[i].~MappedT();
+            } else if (i > 0 && !(keyList[i - 1] < incomingKey)) {
+                // already in the map
+                --j;
+            } else {
+                --j;
+                --w;
+                new (keyList + w) KeyT(std::move(incomingKey));
+                new (valueList + w) MappedT(incoming.second);
+            }
+        }
+
+        m_size = newSize;
+    }
 };
 
 } // namespace Vitrae
\ No newline at end of file
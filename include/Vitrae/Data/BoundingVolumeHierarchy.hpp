@@ -0,0 +1,166 @@
+#pragma once
+
+#include "Vitrae/Data/BoundingBox.hpp"
+#include "Vitrae/Data/Frustum.hpp"
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Vitrae
+{
+
+/**
+ * A 4-wide bounding volume hierarchy over boxes, identified by their indices.
+ * The boxes of a node's children are stored by component, so each frustum plane is tested
+ * against all children at once in a loop the compiler vectorizes
+ */
+class BoundingVolumeHierarchy
+{
+  public:
+    static constexpr std::size_t WIDTH = 4;
+
+    BoundingVolumeHierarchy() = default;
+
+    /**
+     * Replaces the hierarchy with one over the boxes
+     */
+    void build(std::span<const BoundingBox> boxes);
+
+    /**
+     * Replaces the boxes of the items and updates the nodes containing them, keeping the
+     * structure. Much cheaper than build(), but culling gets less efficient the further the boxes
+     * move from where they were when built
+     * @param items The indices of the changed boxes, as given to build(), in any order
+     * @param boxes The new box of each item in items
+     */
+    void refit(std::span<const std::uint32_t> items, std::span<const BoundingBox> boxes);
+
+    void clear();
+
+    /**
+     * @returns The number of boxes in the hierarchy
+     */
+    inline std::size_t count() const { return m_itemIndices.size(); }
+
+    /**
+     * Calls the visitor with the index of every box that intersects the frustum, in no particular
+     * order
+     * @note Conservative like Frustum::intersects
+     */
+    template <class VisitorT>
+    void forEachIntersecting(const Frustum &frustum, VisitorT &&visitor) const
+    {
+        if (m_nodes.empty()) {
+            return;
+        }
+
+        // the hierarchy is balanced, so the depth stays well below what this can hold
+        std::array<std::uint32_t, 64> nodeStack;
+        std::size_t stackSize = 0;
+        nodeStack[stackSize++] = 0;
+
+        while (stackSize > 0) {
+            const Node &node = m_nodes[nodeStack[--stackSize]];
+
+            std::int32_t outside[WIDTH] = {};
+            std::int32_t inside[WIDTH] = {1, 1, 1, 1};
+
+            for (const glm::vec4 &plane : frustum.planes) {
+                // the corners furthest and nearest along the plane normal
+                const float *p_farX = plane.x >= 0.0f ? node.maxX : node.minX;
+                const float *p_farY = plane.y >= 0.0f ? node.maxY : node.minY;
+                const float *p_farZ = plane.z >= 0.0f ? node.maxZ : node.minZ;
+                const float *p_nearX = plane.x >= 0.0f ? node.minX : node.maxX;
+                const float *p_nearY = plane.y >= 0.0f ? node.minY : node.maxY;
+                const float *p_nearZ = plane.z >= 0.0f ? node.minZ : node.maxZ;
+
+                for (std::size_t lane = 0; lane < WIDTH; ++lane) {
+                    float farDistance = plane.x * p_farX[lane] + plane.y * p_farY[lane] +
+                                        plane.z * p_farZ[lane] + plane.w;
+                    float nearDistance = plane.x * p_nearX[lane] + plane.y * p_nearY[lane] +
+                                         plane.z * p_nearZ[lane] + plane.w;
+                    outside[lane] |= farDistance < 0.0f;
+                    inside[lane] &= nearDistance >= 0.0f;
+                }
+            }
+
+            for (std::size_t lane = 0; lane < node.childCount; ++lane) {
+                if (outside[lane]) {
+                    continue;
+                }
+
+                if (node.childNode[lane] == NO_NODE || inside[lane]) {
+                    // the items of a subtree are contiguous, so fully visible ones are
+                    // visited without testing
+                    std::uint32_t end = node.firstItem[lane] + node.itemCount[lane];
+                    for (std::uint32_t i = node.firstItem[lane]; i < end; ++i) {
+                        visitor(static_cast<std::size_t>(m_itemIndices[i]));
+                    }
+                } else {
+                    nodeStack[stackSize++] = node.childNode[lane];
+                }
+            }
+        }
+    }
+
+  private:
+    static constexpr std::uint32_t NO_NODE = ~std::uint32_t(0);
+
+    struct Node
+    {
+        float minX[WIDTH], minY[WIDTH], minZ[WIDTH];
+        float maxX[WIDTH], maxY[WIDTH], maxZ[WIDTH];
+
+        /**
+         * The range of the child's items in m_itemIndices
+         */
+        std::uint32_t firstItem[WIDTH];
+        std::uint32_t itemCount[WIDTH];
+
+        /**
+         * The node of the child, or NO_NODE if the child is a single item
+         */
+        std::uint32_t childNode[WIDTH];
+
+        std::uint32_t childCount;
+    };
+
+    /**
+     * The nodes, with every child node stored after its parent
+     */
+    std::vector<Node> m_nodes;
+
+    /**
+     * The indices of the boxes, ordered so that the items of every subtree are contiguous
+     */
+    std::vector<std::uint32_t> m_itemIndices;
+
+    /**
+     * The lane of each node in its parent, as parentIndex * WIDTH + lane, or NO_NODE for the root
+     */
+    std::vector<std::uint32_t> m_parentSlots;
+
+    /**
+     * The lane holding each box as a single item, as nodeIndex * WIDTH + lane, by box index
+     */
+    std::vector<std::uint32_t> m_itemSlots;
+
+    /**
+     * Whether each node's box needs to be updated by refit(), kept to avoid reallocating
+     */
+    std::vector<std::uint8_t> m_nodeDirtyFlags;
+
+    static void setChildBox(Node &node, std::uint32_t lane, const BoundingBox &box);
+    static BoundingBox getNodeBox(const Node &node);
+
+    /**
+     * Fills the node with children covering the item range, building their nodes
+     * @returns The bounding box of all the items in the range
+     */
+    BoundingBox buildNode(std::uint32_t nodeIndex, std::uint32_t firstItem,
+                          std::uint32_t itemCount, std::span<const BoundingBox> boxes);
+};
+
+} // namespace Vitrae
\ No newline at end of file
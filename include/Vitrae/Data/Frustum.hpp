@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Vitrae/Data/BoundingBox.hpp"
+
+#include "glm/glm.hpp"
+
+namespace Vitrae
+{
+
+/**
+ * The volume visible through a projection, bounded by planes facing inwards
+ */
+struct Frustum
+{
+    /**
+     * The (a, b, c, d) coefficients of the left, right, bottom, top, near and far planes.
+     * Points p inside the frustum have a*p.x + b*p.y + c*p.z + d >= 0 for every plane
+     */
+    glm::vec4 planes[6];
+
+    /**
+     * @returns The frustum of the view-projection matrix, in the space the matrix transforms from
+     * @note Uses the OpenGL clip space, with the depth in [-1, 1]
+     */
+    static Frustum fromViewProjection(const glm::mat4 &viewProjection);
+
+    /**
+     * @returns Whether the box is at least partially inside the frustum
+     * @note Conservative, so boxes near the edges of the frustum can intersect it without being
+     * inside
+     */
+    bool intersects(const BoundingBox &box) const;
+};
+
+} // namespace Vitrae
\ No newline at end of file
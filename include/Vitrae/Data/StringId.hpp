@@ -1,35 +1,82 @@
 #pragma once
 
-#include <cstring>
+#include "Vitrae/Util/PackedKeyTraits.hpp"
+
+#include <cstddef>
 #include <string>
 #include <string_view>
 #include <type_traits>
 
 namespace Vitrae
 {
+/**
+ * A global table of original strings for StringIds, used for debugging purposes.
+ * Strings are interned once per hash and never freed, so the returned views stay valid.
+ * Lookups and insertions are lock-free.
+ * Since all strings get registered, hash collisions are detected as soon as the second
+ * colliding string is hashed. The _sid literals are registered during static initialization,
+ * so collisions between them are detected at startup.
+ * @note Only filled when VITRAE_DEBUG_STRINGIDS is defined
+ */
+class StringIdTable
+{
+  public:
+    static constexpr std::size_t CAPACITY_BITS = 16;
+    static constexpr std::size_t CAPACITY = std::size_t(1) << CAPACITY_BITS;
+
+    /**
+     * Stores the string for the hash, if no string for the hash was stored already
+     * @note If a different string was already stored for the hash, the collision is reported to
+     * stderr and an assertion fails. Doesn't throw, since it's called from StringId constructors
+     */
+    static void intern(std::size_t hash, std::string_view str);
+
+    /**
+     * @returns The string stored for the hash, or an empty view if none was stored
+     */
+    static std::string_view lookup(std::size_t hash);
+
+  private:
+    // slots with hash 0 are empty
+    static std::size_t s_hashes[CAPACITY];
+    static const char *s_strings[CAPACITY];
+
+    static void checkCollision(std::size_t slot, std::string_view str);
+
+    static constexpr std::size_t getHomeSlot(std::size_t hash)
+    {
+        return (hash * 0x9E3779B97F4A7C15ULL) >> (64 - CAPACITY_BITS);
+    }
+};
+
 /**
  * A hash of a string, for quicker comparison and mapping
+ * @note Trivially copyable and the size of its hash in every build mode. With
+ * VITRAE_DEBUG_STRINGIDS the original strings are kept in the StringIdTable
  */
 class StringId
 {
     friend std::hash<StringId>;
 
     std::size_t m_hash;
-#ifdef VITRAE_DEBUG_STRINGIDS
-    char *m_str;
-#endif
 
-    static constexpr std::size_t calcHash(std::string_view str)
-    {
-        // fnv_hash_1a_64
-        std::size_t hash = 0xcbf29ce484222325ULL;
+    static constexpr std::size_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+    static constexpr std::size_t FNV_PRIME = 0x100000001b3ULL;
 
+    static constexpr std::size_t calcHash(std::string_view str,
+                                          std::size_t hash = FNV_OFFSET_BASIS)
+    {
+        // fnv_hash_1a_64; hashing can be continued from the hash of a prefix
         for (char c : str)
-            hash = (hash ^ c) * 0x100000001b3ULL;
+            hash = (hash ^ c) * FNV_PRIME;
 
         return hash;
     }
 
+    struct FromHash
+    {};
+    constexpr StringId(FromHash, std::size_t hash) : m_hash(hash) {}
+
   public:
     constexpr StringId(const char *str) : StringId(std::string_view{str}) {}
     StringId(const std::string &str) : StringId(std::string_view{str}) {}
@@ -38,67 +85,143 @@ class StringId
         m_hash = calcHash(str);
 
 #ifdef VITRAE_DEBUG_STRINGIDS
-        if (std::is_constant_evaluated()) {
-            m_str = nullptr;
-        } else {
-            m_str = new char[str.size() + 1];
-            std::copy(str.begin(), str.end(), m_str);
-            m_str[str.size()] = '\0';
+        if (!std::is_constant_evaluated()) {
+            StringIdTable::intern(m_hash, str);
         }
 #endif
     }
-    constexpr StringId(StringId &&id)
+
+    /**
+     * @returns The id of prefix + suffix, without allocating the concatenated string
+     * @note Equal to StringId(String(prefix) + String(suffix))
+     */
+    static constexpr StringId concat(std::string_view prefix, std::string_view suffix)
     {
-        m_hash = id.m_hash;
+        StringId ret(FromHash{}, calcHash(suffix, calcHash(prefix)));
+
 #ifdef VITRAE_DEBUG_STRINGIDS
-        m_str = id.m_str;
-        id.m_str = nullptr;
+        if (!std::is_constant_evaluated()) {
+            StringIdTable::intern(ret.m_hash, std::string(prefix) + std::string(suffix));
+        }
 #endif
+
+        return ret;
     }
-    constexpr StringId(const StringId &id)
+
+    /**
+     * @returns The id of this id's string with the suffix appended
+     * @note Useful with ids known only by their hash, like _sid literals. Prefer concat() when
+     * the prefix string is available, since the debug name can be kept then
+     */
+    constexpr StringId appended(std::string_view suffix) const
     {
-        m_hash = id.m_hash;
+        StringId ret(FromHash{}, calcHash(suffix, m_hash));
+
 #ifdef VITRAE_DEBUG_STRINGIDS
-        if (id.m_str) {
-            m_str = new char[std::strlen(id.m_str) + 1];
-            std::strcpy(m_str, id.m_str);
-        } else {
-            m_str = nullptr;
+        if (!std::is_constant_evaluated()) {
+            std::string_view prefix = debugName();
+            if (!prefix.empty()) {
+                StringIdTable::intern(ret.m_hash, std::string(prefix) + std::string(suffix));
+            }
         }
 #endif
+
+        return ret;
     }
 
-#ifdef VITRAE_DEBUG_STRINGIDS
-    constexpr ~StringId()
+    /**
+     * Stores the string as the debug name of the id, for ids created in constant expressions
+     * by concat() or appended(), which can't be registered on creation
+     * @note Does nothing unless VITRAE_DEBUG_STRINGIDS is defined
+     */
+    void registerDebugName(std::string_view str) const
     {
-        if (m_str)
-            delete[] m_str;
-    }
+#ifdef VITRAE_DEBUG_STRINGIDS
+        StringIdTable::intern(m_hash, str);
 #endif
+    }
 
-    constexpr StringId &operator=(StringId id)
+    constexpr StringId(const StringId &id) = default;
+    constexpr StringId &operator=(const StringId &id) = default;
+
+    /**
+     * @returns The original string if it is known, otherwise an empty view
+     * @note Always empty unless VITRAE_DEBUG_STRINGIDS is defined
+     */
+    std::string_view debugName() const
     {
-        m_hash = id.m_hash;
 #ifdef VITRAE_DEBUG_STRINGIDS
-        if (id.m_str) {
-            m_str = new char[std::strlen(id.m_str) + 1];
-            std::strcpy(m_str, id.m_str);
-        } else {
-            m_str = nullptr;
-        }
+        return StringIdTable::lookup(m_hash);
+#else
+        return {};
 #endif
-        return *this;
     }
 
     constexpr bool operator==(StringId id) const { return m_hash == id.m_hash; }
     constexpr auto operator<=>(StringId id) const { return m_hash <=> id.m_hash; }
 };
+
+/**
+ * A string literal usable as a template argument, for the _sid literals
+ */
+template <std::size_t N> struct StringIdLiteral
+{
+    char chars[N];
+
+    consteval StringIdLiteral(const char (&str)[N])
+    {
+        for (std::size_t i = 0; i < N; ++i) {
+            chars[i] = str[i];
+        }
+    }
+
+    constexpr std::string_view view() const { return std::string_view(chars, N - 1); }
+};
 } // namespace Vitrae
 
 namespace std
 {
 template <> struct hash<Vitrae::StringId>
 {
-    size_t operator()(const Vitrae::StringId &x) const { return x.m_hash; }
+    constexpr size_t operator()(const Vitrae::StringId &x) const { return x.m_hash; }
+};
+} // namespace std
+
+namespace Vitrae
+{
+/**
+ * StringIds are ordered by their hashes, so they can be searched as packed 64-bit integers
+ */
+template <> struct PackedKeyTraits<StringId>
+{
+    static constexpr bool isPacked = sizeof(StringId) == sizeof(std::uint64_t);
+
+    static std::uint64_t toPacked(const StringId &key) { return std::hash<StringId>{}(key); }
+};
+
+#ifdef VITRAE_DEBUG_STRINGIDS
+/**
+ * Registers the literal's string during static initialization, once per distinct literal
+ */
+template <StringIdLiteral Literal> struct StringIdLiteralRegistration
+{
+    static inline const bool registered =
+        (StringIdTable::intern(std::hash<StringId>{}(StringId(Literal.view())), Literal.view()),
+         true);
 };
-} // namespace std
\ No newline at end of file
+#endif
+
+/**
+ * @returns The StringId of the literal, always hashed at compile time
+ * @note With VITRAE_DEBUG_STRINGIDS, the literal's string is registered at startup
+ */
+template <StringIdLiteral Literal> consteval StringId operator""_sid()
+{
+#ifdef VITRAE_DEBUG_STRINGIDS
+    // odr-uses the registration, which instantiates it for the literal
+    (void)&StringIdLiteralRegistration<Literal>::registered;
+#endif
+
+    return StringId(Literal.view());
+}
+} // namespace Vitrae
\ No newline at end of file
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Vitrae/Data/Transformation.hpp"
+
+#include "glm/glm.hpp"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Vitrae
+{
+
+/**
+ * Transformations stored by component, with their model matrices cached.
+ * Changed transformations are marked dirty, and only their matrices are recomputed on update
+ */
+class TransformStore
+{
+  public:
+    TransformStore() = default;
+
+    /**
+     * @returns The index of the added transformation
+     */
+    std::size_t add(const SimpleTransformation &transform);
+
+    void clear();
+
+    inline std::size_t count() const { return m_positions.size(); }
+
+    SimpleTransformation get(std::size_t index) const;
+    void set(std::size_t index, const SimpleTransformation &transform);
+
+    inline const glm::vec3 &getPosition(std::size_t index) const { return m_positions[index]; }
+    inline const glm::quat &getRotation(std::size_t index) const { return m_rotations[index]; }
+    inline const glm::vec3 &getScaling(std::size_t index) const { return m_scalings[index]; }
+
+    void setPosition(std::size_t index, const glm::vec3 &position);
+    void setRotation(std::size_t index, const glm::quat &rotation);
+    void setScaling(std::size_t index, const glm::vec3 &scaling);
+
+    /**
+     * @returns The model matrix of the transformation, as of the last updateMatrices()
+     */
+    inline const glm::mat4 &getModelMatrix(std::size_t index) const
+    {
+        return m_modelMatrices[index];
+    }
+
+    /**
+     * @returns Whether any transformation changed since the last updateMatrices()
+     */
+    inline bool hasChanges() const { return !m_dirtyIndices.empty(); }
+
+    /**
+     * @returns The indices of the transformations changed since the last updateMatrices(), in no
+     * particular order
+     */
+    inline std::span<const std::uint32_t> getChangedIndices() const { return m_dirtyIndices; }
+
+    /**
+     * Recomputes the model matrices of the transformations changed since the last update
+     * @returns The number of recomputed matrices
+     */
+    std::size_t updateMatrices();
+
+  protected:
+    std::vector<glm::vec3> m_positions;
+    std::vector<glm::quat> m_rotations;
+    std::vector<glm::vec3> m_scalings;
+    std::vector<glm::mat4> m_modelMatrices;
+
+    /**
+     * Whether each transformation is in m_dirtyIndices
+     */
+    std::vector<std::uint8_t> m_dirtyFlags;
+    std::vector<std::uint32_t> m_dirtyIndices;
+
+    void markDirty(std::size_t index);
+};
+
+} // namespace Vitrae
\ No newline at end of file
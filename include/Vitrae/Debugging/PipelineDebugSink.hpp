@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Vitrae/Data/Typedefs.hpp"
+#include "Vitrae/Util/NonCopyable.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace Vitrae
+{
+
+/**
+ * Writes debug exports of pipelines, such as their graphs, to files on a background thread.
+ * Disabled by default, in which case exporters should skip producing the content altogether
+ * @note Thread safe
+ */
+class PipelineDebugSink : public NonCopyable
+{
+  public:
+    PipelineDebugSink();
+
+    /**
+     * Writes the remaining queued files and joins the writer thread
+     */
+    ~PipelineDebugSink();
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * Sets the directory to write the files to, created when needed. Defaults to "shaderdebug"
+     */
+    void setDirectory(std::filesystem::path directory);
+
+    /**
+     * @returns The path the file with the filename is written to
+     */
+    std::filesystem::path getFilePath(StringView filename) const;
+
+    /**
+     * Queues the content to be written to the file in the directory
+     * @note Ignored if the sink is disabled
+     */
+    void write(String filename, String content);
+
+    /**
+     * Waits until all queued files are written
+     */
+    void flush();
+
+  private:
+    std::atomic<bool> m_enabled;
+
+    /**
+     * Guards the members below
+     */
+    mutable std::mutex m_mutex;
+    std::condition_variable m_queueCondition;
+    std::condition_variable m_flushCondition;
+
+    std::filesystem::path m_directory;
+    std::deque<std::pair<std::filesystem::path, String>> m_queue;
+    bool m_writing;
+    bool m_stopping;
+
+    /**
+     * Started on the first write
+     */
+    std::thread m_writerThread;
+
+    void writerLoop();
+};
+
+} // namespace Vitrae
\ No newline at end of file
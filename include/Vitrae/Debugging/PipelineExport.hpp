@@ -2,6 +2,7 @@
 
 #include "Vitrae/Pipelines/Pipeline.hpp"
 #include "Vitrae/Pipelines/PipelineContainer.hpp"
+#include "Vitrae/Pipelines/TaskGraph.hpp"
 #include "Vitrae/TypeConversion/StringCvt.hpp"
 #include "Vitrae/Util/StringProcessing.hpp"
 
@@ -15,7 +16,9 @@ namespace Vitrae
 {
 
 /**
- * @returns The unique identifier for the pipeline dependant for relevant aliases
+ * @returns A readable identifier for the pipeline, listing its outputs and relevant aliases
+ * @note Builds a long string, so it is meant for display only. Use Pipeline::fingerprint to
+ * identify pipelines
  */
 template <TaskChild BasicTask>
 inline String getPipelineId(const Pipeline<BasicTask> &pipeline, const ParamAliases &aliases)
@@ -481,4 +484,55 @@ void exportPipeline(const Pipeline<BasicTask> &pipeline, const ParamAliases &ali
     }
 }
 
+/**
+ * @brief Exports the dependency graph of the pipeline's tasks in the dot language.
+ * Tasks that can run concurrently are filled green
+ * @param pipeline The pipeline to export
+ * @param graph The task graph of the pipeline
+ * @param out The output stream to which to write
+ */
+template <TaskChild BasicTask>
+void exportTaskGraph(const Pipeline<BasicTask> &pipeline, const TaskGraph<BasicTask> &graph,
+                     std::ostream &out)
+{
+    auto escapedLabel = [&](StringView label) -> String {
+        String ret = searchAndReplace(String(label), "\"", "\\\"");
+        ret = searchAndReplace(ret, "\n", "\\n");
+        return ret;
+    };
+
+    out << "digraph {\n";
+    out << "\trankdir=\"LR\"\n";
+
+    for (std::size_t index = 0; index < pipeline.items.size(); ++index) {
+        const BasicTask &task = *pipeline.items[index];
+
+        out << "\tTask_" << index << " [";
+        out << "label=\""
+            << escapedLabel(String("#") + std::to_string(index + 1) + "\n" +
+                            String(task.getFriendlyName()))
+            << "\", ";
+        out << "shape=box, ";
+        out << "style=\"filled\", ";
+        if constexpr (requires { task.canRunConcurrently(); }) {
+            if (task.canRunConcurrently()) {
+                out << "fillcolor=\"palegreen\", ";
+            } else {
+                out << "fillcolor=\"lightblue\", ";
+            }
+        } else {
+            out << "fillcolor=\"lightblue\", ";
+        }
+        out << "];\n";
+    }
+
+    for (std::size_t index = 0; index < graph.nodes.size(); ++index) {
+        for (std::size_t dependency : graph.nodes[index].dependencies) {
+            out << "\tTask_" << dependency << " -> Task_" << index << ";\n";
+        }
+    }
+
+    out << "}";
+}
+
 } // namespace Vitrae
\ No newline at end of file
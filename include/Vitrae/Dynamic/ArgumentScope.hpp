@@ -14,6 +14,7 @@ class ArgumentScope
 {
     VariantScope *mp_scope;
     const ParamAliases *mp_propertySelection;
+    const ParamSlotTable *mp_slots;
 
   public:
     /**
@@ -27,10 +28,15 @@ class ArgumentScope
      * @brief Constructor with a VariantScope.
      *
      * Creates a ArgumentScope with the specified scope and aliases.
+     * If a slot table is specified, names requested by the pipeline's tasks are resolved through
+     * it instead of the aliases.
      *
      * @param scope Pointer to the VariantScope.
+     * @param p_slots The slot table of the pipeline built with the same aliases. The scope must
+     * have it bound
      */
-    ArgumentScope(VariantScope *p_scope, const ParamAliases *propertySelection = nullptr);
+    ArgumentScope(VariantScope *p_scope, const ParamAliases *propertySelection = nullptr,
+                  const ParamSlotTable *p_slots = nullptr);
 
     /// @brief Copy constructor.
     ArgumentScope(const ArgumentScope &) = default;
@@ -101,6 +107,29 @@ class ArgumentScope
      */
     bool has(StringId key) const;
 
+    /**
+     * @return The slot of the key resolved when the pipeline was built, or
+     * ParamSlotTable::NO_SLOT if the key has no slot.
+     * @note Tasks can resolve the slots of their keys once per pipeline (e.g. in
+     * prepareRequiredLocalAssets) and access the values by index afterwards
+     */
+    std::size_t slotFor(StringId key) const;
+
+    /// @brief Set the value of a slot.
+    void setSlot(std::size_t slot, const Variant &value) { mp_scope->setSlot(slot, value); }
+
+    /// @brief Set the value of a slot using move semantics.
+    void setSlot(std::size_t slot, Variant &&value) { mp_scope->setSlot(slot, std::move(value)); }
+
+    /// @brief Get the value of a slot.
+    const Variant &getSlot(std::size_t slot) const { return mp_scope->getSlot(slot); }
+
+    /// @brief Get a move-reference to the value of a slot.
+    Variant moveSlot(std::size_t slot) { return mp_scope->moveSlot(slot); }
+
+    /// @brief Check if a slot has a value.
+    bool hasSlot(std::size_t slot) const { return mp_scope->hasSlot(slot); }
+
     /**
      * @return The underlying VariantScope
      */
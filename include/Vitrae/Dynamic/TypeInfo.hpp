@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Vitrae/Data/StringId.hpp"
 #include "Vitrae/Dynamic/TypeMeta.hpp"
 #include "Vitrae/TypeConversion/VectorCvt.hpp"
 
@@ -23,6 +24,12 @@ class TypeInfo
 {
   public:
     const std::type_info *p_id;
+    /**
+     * A per-type id, computed at compile time from the type's signature.
+     * Unlike std::type_info comparisons, comparing ids is a single integer compare, even across
+     * shared library boundaries. Only matching ids need the type_info comparison
+     */
+    StringId typeId;
     std::size_t size;
     std::size_t alignment;
 
@@ -35,19 +42,31 @@ class TypeInfo
 
     inline std::string_view getShortTypeName() const { return shortTypeNameGetter(); }
 
-    // comparisons (just compare type_info)
-    inline bool operator==(const TypeInfo &o) const { return *p_id == *o.p_id; }
+    /*
+    Comparisons. Different type ids quickly reject different types. Equal ids are confirmed with
+    the type_info, since the signatures of types local to different translation units, such as in
+    anonymous namespaces, can be spelled the same, and the hashes can collide
+    */
+    inline bool operator==(const TypeInfo &o) const
+    {
+        return typeId == o.typeId && (p_id == o.p_id || *p_id == *o.p_id);
+    }
     inline std::weak_ordering operator<=>(const TypeInfo &o) const
     {
-        if (*p_id == *o.p_id) {
+        if (auto cmp = typeId <=> o.typeId; cmp != 0) {
+            return cmp;
+        }
+        if (p_id == o.p_id || *p_id == *o.p_id) {
             return std::weak_ordering::equivalent;
-        } else if (p_id->before(*o.p_id)) {
-            return std::weak_ordering::less;
-        } else {
-            return std::weak_ordering::greater;
         }
+        return p_id->before(*o.p_id) ? std::weak_ordering::less : std::weak_ordering::greater;
     }
 
+    /**
+     * @returns A hash of the type, equal for the same type in all shared libraries
+     */
+    constexpr std::size_t hash() const { return std::hash<StringId>{}(typeId); }
+
     // Getter
     template <typename T> static consteval TypeInfo construct()
     {
@@ -64,7 +83,8 @@ class TypeInfo
 
         std::string_view (*shortTypeNameGetter)() = getShortTypeName<T>;
 
-        return TypeInfo(p_id, size, alignment, TYPE_META<T>, shortTypeNameGetter);
+        return TypeInfo(p_id, StringId(getTypeSignature<T>()), size, alignment, TYPE_META<T>,
+                        shortTypeNameGetter);
     }
 
   protected:
@@ -75,10 +95,10 @@ class TypeInfo
     TypeInfo &operator=(const TypeInfo &) = delete;
     TypeInfo &operator=(TypeInfo &&) = delete;
 
-    constexpr TypeInfo(const std::type_info *p_id, std::size_t size, std::size_t alignment,
-                       const PolymorphicTypeMeta &metaDetail,
+    constexpr TypeInfo(const std::type_info *p_id, StringId typeId, std::size_t size,
+                       std::size_t alignment, const PolymorphicTypeMeta &metaDetail,
                        std::string_view (*shortTypeNameGetter)())
-        : p_id(p_id), size(size), alignment(alignment), metaDetail(metaDetail),
+        : p_id(p_id), typeId(typeId), size(size), alignment(alignment), metaDetail(metaDetail),
           shortTypeNameGetter(shortTypeNameGetter)
     {}
 
@@ -86,6 +106,17 @@ class TypeInfo
     std::string_view (*shortTypeNameGetter)();
     // utilities
     static std::string constructShortTypeName(const std::type_info *p_id);
+    /**
+     * @returns The compiler's signature of this function, which uniquely contains the type name
+     */
+    template <class T> static consteval std::string_view getTypeSignature()
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        return __FUNCSIG__;
+#else
+        return __PRETTY_FUNCTION__;
+#endif
+    }
     template <class T> static std::string_view getShortTypeName()
     {
         static std::string name = constructShortTypeName(&typeid(T));
@@ -3,12 +3,21 @@
 #include "Vitrae/Dynamic/TypeInfo.hpp"
 
 #include <any>
+#include <cassert>
 #include <cstdlib>
 #include <sstream>
 #include <stdexcept>
 #include <string>
 #include <typeinfo>
 
+/**
+ * The number of bytes a Variant can store without a heap allocation.
+ * The default fits a glm::mat4, so per-frame matrix properties don't allocate
+ */
+#ifndef VITRAE_VARIANT_INLINE_BYTES
+#define VITRAE_VARIANT_INLINE_BYTES 64
+#endif
+
 namespace Vitrae
 {
 
@@ -43,8 +52,12 @@ class VariantVTable
     VariantVTable &operator=(const VariantVTable &) = default;
     VariantVTable &operator=(VariantVTable &&) = default;
 
-    bool operator==(const VariantVTable &o) const { return *p_typeinfo == *o.p_typeinfo; }
-    bool operator!=(const VariantVTable &o) const { return *p_typeinfo != *o.p_typeinfo; }
+    // same vtable means same type, so avoid dereferencing the type infos in that common case
+    bool operator==(const VariantVTable &o) const
+    {
+        return this == &o || *p_typeinfo == *o.p_typeinfo;
+    }
+    bool operator!=(const VariantVTable &o) const { return !(*this == o); }
     bool operator<(const VariantVTable &o) const { return *p_typeinfo < *o.p_typeinfo; }
     bool operator>(const VariantVTable &o) const { return *p_typeinfo > *o.p_typeinfo; }
     bool operator<=(const VariantVTable &o) const { return *p_typeinfo <= *o.p_typeinfo; }
@@ -313,6 +326,23 @@ class Variant
         return getUnsafe<T>();
     }
 
+    /**
+     * @tparam T The type to retrieve the value as.
+     * @return The value stored as type `T`, without checking the stored type.
+     * @note Only for values whose type was already validated, like task inputs whose specs were
+     * checked when the pipeline was built. Using the wrong type is undefined behavior
+     */
+    template <class T> constexpr T &get_unchecked()
+    {
+        assert(*m_table == V_TABLE<std::decay_t<T>>);
+        return getUnsafe<T>();
+    }
+    template <class T> constexpr const T &get_unchecked() const
+    {
+        assert(*m_table == V_TABLE<std::decay_t<T>>);
+        return getUnsafe<T>();
+    }
+
     // comparison operators
 
     /**
@@ -345,7 +375,7 @@ class Variant
      */
     constexpr std::size_t hash() const
     {
-        return m_table->hash(*this) ^ m_table->p_typeinfo->p_id->hash_code();
+        return m_table->hash(*this) ^ m_table->p_typeinfo->hash();
     }
 
   private:
@@ -356,9 +386,12 @@ class Variant
      */
     union {
         void *mp_longVal;
-        char m_shortBufferVal[sizeof(void *) * 2]; // size of two pointers, because many stored
-                                                   // variant data consists of 2 pointers
+        char m_shortBufferVal[VITRAE_VARIANT_INLINE_BYTES]; // at least two pointers, because
+                                                            // many stored values consist of 2
+                                                            // pointers
     } m_val;
+    static_assert(VITRAE_VARIANT_INLINE_BYTES >= sizeof(void *) * 2,
+                  "Variant has to store at least two pointers inline");
     /**
      * Pointer to the function table
      */
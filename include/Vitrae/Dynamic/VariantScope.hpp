@@ -1,10 +1,13 @@
 #pragma once
 
-#include "Vitrae/Containers/StableMap.hpp"
+#include "Vitrae/Containers/LookupMap.hpp"
 #include "Vitrae/Data/StringId.hpp"
 #include "Vitrae/Dynamic/Variant.hpp"
+#include "Vitrae/Params/ParamSlotTable.hpp"
 
 #include <map>
+#include <optional>
+#include <vector>
 
 namespace Vitrae
 {
@@ -19,8 +22,20 @@ namespace Vitrae
  */
 class VariantScope
 {
+    /// Scopes are modified every frame, so we prefer fast insertion over ordering
+    static constexpr LookupPolicy DICT_POLICY = LookupPolicy::Hashed;
+
     const VariantScope *m_parent;
-    StableMap<StringId, Variant> m_dict;
+    LookupMap<StringId, Variant, DICT_POLICY> m_dict;
+
+    /// Values of the properties that have slots in the bound table; the rest are in m_dict
+    const ParamSlotTable *mp_slots;
+    std::vector<std::optional<Variant>> m_slotValues;
+
+    inline std::size_t findSlot(StringId key) const
+    {
+        return mp_slots ? mp_slots->findSlot(key) : ParamSlotTable::NO_SLOT;
+    }
 
   public:
     /**
@@ -124,5 +139,55 @@ class VariantScope
      * @brief Erases all keys and values from the dictionary.
      */
     void clear();
+
+    /**
+     * @brief Stores the properties of the slot table in dense slots, accessible by index.
+     *
+     * Values of the previously bound table are moved back to the dictionary, and values of the
+     * new table's properties are moved from the dictionary to the slots.
+     * Name-based access keeps working for all properties.
+     *
+     * @param p_slots The slot table, or nullptr to unbind.
+     * @warning The table is non-owning, and MUST exist until it is unbound
+     */
+    void bindSlots(const ParamSlotTable *p_slots);
+
+    /**
+     * @return The bound slot table, or nullptr if none is bound.
+     */
+    inline const ParamSlotTable *getSlotTable() const { return mp_slots; }
+
+    /**
+     * @brief Set the value of a slot of the bound table.
+     */
+    void setSlot(std::size_t slot, const Variant &value);
+
+    /**
+     * @brief Set the value of a slot of the bound table using move semantics.
+     */
+    void setSlot(std::size_t slot, Variant &&value);
+
+    /**
+     * @brief Get the value of a slot of the bound table.
+     *
+     * If the slot is not set, the search continues in the parent dictionary by the slot's name.
+     *
+     * @throws std::runtime_error If the value is not found in any dictionary.
+     */
+    const Variant &getSlot(std::size_t slot) const;
+
+    /**
+     * @brief Get a move-reference to the value of a slot of the bound table.
+     *
+     * If the slot is not set, the value is copied from the parent dictionary.
+     *
+     * @throws std::runtime_error If the value is not found in any dictionary.
+     */
+    Variant moveSlot(std::size_t slot);
+
+    /**
+     * @brief Check if a slot of the bound table has a value, or the parent has its property.
+     */
+    bool hasSlot(std::size_t slot) const;
 };
 } // namespace Vitrae
\ No newline at end of file
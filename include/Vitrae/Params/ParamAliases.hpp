@@ -1,10 +1,12 @@
 #pragma once
 
+#include "Vitrae/Containers/FlatHashMap.hpp"
 #include "Vitrae/Containers/StableMap.hpp"
 #include "Vitrae/Data/StringId.hpp"
 #include "Vitrae/Data/Typedefs.hpp"
 
 #include <optional>
+#include <span>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -19,6 +21,8 @@ namespace Vitrae {
  * The collection of all aliases is called a selection
  * Providers can also be proxies to other providers
  * No cycles are allowed
+ * The aliases of the parents are flattened into each selection when it's constructed,
+ * and alias chains are resolved then, so each lookup is a single hash table probe
  */
 class ParamAliases
 {
@@ -51,7 +55,7 @@ class ParamAliases
     /**
      * Constructor for alias mapping with inheritance
      * @param parent The parent ParamAliases
-     * @warning The parent pointers are non-owning, and MUST exist until this object's destruction
+     * @note The parents' aliases are copied, so the parents don't have to outlive this object
      */
     ParamAliases(std::span<const ParamAliases *const> parentPtrs);
 
@@ -60,7 +64,7 @@ class ParamAliases
      * @param parent The parent ParamAliases
      * @param aliases A map of aliases; key = proxy, value = provider
      * (choice)
-     * @warning The parent pointers are non-owning, and MUST exist until this object's destruction
+     * @note The parents' aliases are copied, so the parents don't have to outlive this object
      */
     ParamAliases(std::span<const ParamAliases *const> parentPtrs,
                  const StableMap<StringId, String> &aliases);
@@ -103,11 +107,25 @@ class ParamAliases
     std::optional<String> directChoiceStringFor(StringId proxy) const;
 
     /**
-     * @returns The has unique for this selection of providers. Order is
+     * @returns The selection of only the specified proxies, each aliased directly to its final
+     * provider
+     * @note Proxies that aren't aliased are skipped
+     */
+    ParamAliases subset(std::span<const StringId> proxies) const;
+
+    /**
+     * @returns The hash of this selection of providers. Order is
      * unimportant, just as the parent-child hierarchy
+     * @note Different selections can have the same hash; compare them with operator== to be sure
      */
     inline std::size_t hash() const { return m_hash; }
 
+    /**
+     * @returns Whether both selections contain exactly the same aliases,
+     * regardless of where they were inherited from
+     */
+    bool operator==(const ParamAliases &other) const;
+
     /**
      * @brief Extracts all aliases used in this selection, including parents
      * @note The map is expected to not have any aliases of this selection already
@@ -129,9 +147,22 @@ class ParamAliases
     void extractAliasProxyIds(std::unordered_set<StringId> &proxys) const;
 
   private:
-    std::vector<const ParamAliases *> m_parentPtrs;
-    StableMap<StringId, std::pair<StringId, String>> m_localAliases;
+    /**
+     * All direct aliases, including the parents'; key = proxy, value = provider
+     */
+    FlatHashMap<StringId, std::pair<StringId, String>> m_directAliases;
+
+    /**
+     * Final providers of all proxies, with alias chains already followed
+     */
+    FlatHashMap<StringId, std::pair<StringId, String>> m_resolvedAliases;
+
     std::size_t m_hash;
+
+    void addLocalAliases(const StableMap<StringId, String> &aliases);
+    void addParentAliases(std::span<const ParamAliases *const> parentPtrs);
+    void resolveAliases();
+    void recalculateHash();
 };
 
 } // namespace Vitrae
@@ -8,26 +8,39 @@
 #include "dynasma/util/dynamic_typing.hpp"
 
 #include <map>
+#include <memory>
 #include <span>
 #include <vector>
 
 namespace Vitrae
 {
 
+/**
+ * An ordered list of param specs, unique by name.
+ * The specs are kept in immutable storage shared between copies, so copying is a pointer copy.
+ * Modifying a list with shared storage copies the storage first.
+ * Interned lists share the storage with all equal interned lists, so they are compared by identity
+ */
 class ParamList : public dynasma::PolymorphicBase
 {
     friend struct std::hash<ParamList>;
 
-    StableMap<StringId, ParamSpec> m_mappedSpecs;
-    std::vector<StringId> m_specNameIds;
-    std::vector<ParamSpec> m_specList;
+    struct Storage
+    {
+        StableMap<StringId, ParamSpec> mappedSpecs;
+        std::vector<StringId> specNameIds;
+        std::vector<ParamSpec> specList;
+
+        std::size_t hash = 0;
+        bool interned = false;
+    };
 
-    std::size_t m_hash;
+    std::shared_ptr<const Storage> mp_storage;
 
   public:
-    inline ParamList() : m_hash(0) {}
+    ParamList();
     ParamList(ParamList const &) = default;
-    ParamList(ParamList &&) = default;
+    ParamList(ParamList &&other);
 
     ParamList(std::initializer_list<const ParamSpec> specs);
     template <class ContainerT>
@@ -35,21 +48,23 @@ class ParamList : public dynasma::PolymorphicBase
         requires(std::ranges::range<ContainerT> &&
                  std::convertible_to<std::ranges::range_value_t<ContainerT>, const ParamSpec &>)
     {
+        auto p_storage = std::make_shared<Storage>();
         for (const auto &spec : specs) {
-            m_specNameIds.push_back(spec.name);
-            m_specList.push_back(spec);
-            m_mappedSpecs.emplace(spec.name, spec);
+            p_storage->specNameIds.push_back(spec.name);
+            p_storage->specList.push_back(spec);
         }
 
-        recalculateHash();
+        rebuildMappedSpecs(*p_storage);
+        recalculateHash(*p_storage);
+        mp_storage = std::move(p_storage);
     }
     ParamList(const StableMap<StringId, ParamSpec> &mappedSpecs);
     ParamList(StableMap<StringId, ParamSpec> &&mappedSpecs);
 
     virtual ~ParamList() = default;
 
-    ParamList &operator=(const ParamList &other);
-    ParamList &operator=(ParamList &&other) = default;
+    ParamList &operator=(const ParamList &other) = default;
+    ParamList &operator=(ParamList &&other);
 
     /**
      * Inserts specs from other at the end of this list, if they are not already in the list
@@ -71,35 +86,71 @@ class ParamList : public dynasma::PolymorphicBase
      */
     void erase(const StringId &nameId);
 
+    /**
+     * Shares the storage with equal interned lists, interning it if there are none yet.
+     * Meant for lists that are done being built and will be kept or compared
+     * @note Lists with default values aren't interned, since values can't always be compared
+     * @note Thread safe
+     */
+    void intern();
+
     /*
     Getters
     */
 
-    inline const StableMap<StringId, ParamSpec> &getMappedSpecs() const { return m_mappedSpecs; }
+    inline const StableMap<StringId, ParamSpec> &getMappedSpecs() const
+    {
+        return mp_storage->mappedSpecs;
+    }
 
-    inline std::span<const StringId> getSpecNameIds() const { return m_specNameIds; }
+    inline std::span<const StringId> getSpecNameIds() const { return mp_storage->specNameIds; }
 
-    inline std::span<const ParamSpec> getSpecList() const { return m_specList; }
+    inline std::span<const ParamSpec> getSpecList() const { return mp_storage->specList; }
 
-    inline std::size_t getHash() const { return m_hash; }
+    inline std::size_t getHash() const { return mp_storage->hash; }
 
     /*
     Info
     */
 
-    inline std::size_t count() const { return m_specList.size(); }
+    inline std::size_t count() const { return mp_storage->specList.size(); }
 
     bool contains(StringId nameId) const;
 
+    inline bool isInterned() const { return mp_storage->interned; }
+
     /*
     Comparisons
     */
 
-    inline bool operator==(const ParamList &other) const { return m_hash == other.m_hash; }
-    inline auto operator<=>(const ParamList &other) const { return m_hash <=> other.m_hash; }
+    inline bool operator==(const ParamList &other) const
+    {
+        if (mp_storage == other.mp_storage) {
+            return true;
+        }
+        if (mp_storage->interned && other.mp_storage->interned) {
+            return false;
+        }
+        return mp_storage->hash == other.mp_storage->hash;
+    }
+    inline auto operator<=>(const ParamList &other) const
+    {
+        return mp_storage->hash <=> other.mp_storage->hash;
+    }
 
   private:
-    void recalculateHash();
+    /**
+     * @returns The storage, copied first if it is shared
+     */
+    Storage &getModifiableStorage();
+
+    /**
+     * @returns The interned storage of the empty list, used by moved-from lists too
+     */
+    static const std::shared_ptr<const Storage> &getEmptyStorage();
+
+    static void rebuildMappedSpecs(Storage &storage);
+    static void recalculateHash(Storage &storage);
 };
 
 inline const ParamList EMPTY_PROPERTY_LIST{};
@@ -111,6 +162,6 @@ namespace std
 
 template <> struct hash<Vitrae::ParamList>
 {
-    std::size_t operator()(const Vitrae::ParamList &pl) const { return pl.m_hash; }
+    std::size_t operator()(const Vitrae::ParamList &pl) const { return pl.getHash(); }
 };
 } // namespace std
\ No newline at end of file
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Vitrae/Containers/FlatHashMap.hpp"
+#include "Vitrae/Data/StringId.hpp"
+
+#include <vector>
+
+namespace Vitrae
+{
+
+/**
+ * Dense indices (slots) of the properties used by a pipeline, assigned when the pipeline is built.
+ * Each slot belongs to one actual (aliased) property name.
+ * The table also maps the names requested by the pipeline's tasks to the slots of their choices,
+ * so accessing properties through it skips the alias resolution.
+ */
+class ParamSlotTable
+{
+  public:
+    static constexpr std::size_t NO_SLOT = ~std::size_t(0);
+
+    ParamSlotTable() = default;
+    ParamSlotTable(const ParamSlotTable &) = default;
+    ParamSlotTable(ParamSlotTable &&) = default;
+
+    ParamSlotTable &operator=(const ParamSlotTable &) = default;
+    ParamSlotTable &operator=(ParamSlotTable &&) = default;
+
+    /**
+     * Assigns a slot to the actual property name, if it doesn't have one already
+     * @returns The slot of the property
+     */
+    std::size_t addSlot(StringId actualName);
+
+    /**
+     * Makes the requested name refer to the slot of its actual name
+     * @note Does nothing if the actual name doesn't have a slot
+     */
+    void addRequestedName(StringId requestedName, StringId actualName);
+
+    /**
+     * @returns The slot of the actual property name, or NO_SLOT if not in the table
+     */
+    std::size_t findSlot(StringId actualName) const;
+
+    /**
+     * @returns The slot for the name requested by a task, or NO_SLOT if not in the table
+     */
+    std::size_t findRequestedSlot(StringId requestedName) const;
+
+    /**
+     * @returns The actual property name of the slot
+     */
+    inline StringId getActualName(std::size_t slot) const { return m_actualNames[slot]; }
+
+    /**
+     * @returns The number of slots
+     */
+    inline std::size_t size() const { return m_actualNames.size(); }
+
+  private:
+    std::vector<StringId> m_actualNames;
+    FlatHashMap<StringId, std::size_t> m_slotPerActualName;
+    FlatHashMap<StringId, std::size_t> m_slotPerRequestedName;
+};
+
+} // namespace Vitrae
\ No newline at end of file
@@ -9,6 +9,8 @@
 
 #include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 namespace Vitrae {
@@ -62,6 +64,10 @@ class ComposeAdaptTasks : public ComposeTask, public PipelineContainer<ComposeTa
     ParamAliases constructContainedPipelineAliases(const ParamAliases &aliases) const override;
 
     void rebuildContainedPipeline(const ParamAliases &aliases) const override;
+    bool isContainedPipelineAffected(const ParamAliases &oldAliases,
+                                     const ParamAliases &newAliases) const override;
+    void retargetContainedPipeline(const ParamAliases &oldAliases,
+                                   const ParamAliases &newAliases) const override;
 
     void run(RenderComposeContext ctx) const override;
     void prepareRequiredLocalAssets(RenderComposeContext ctx) const override;
@@ -78,7 +84,12 @@ class ComposeAdaptTasks : public ComposeTask, public PipelineContainer<ComposeTa
          */
         StableMap<StringId, StringId> finishingMapping;
 
-        Pipeline<ComposeTask> pipeline;
+        /**
+         * The adaptor's aliases on top of the external ones, used by the contained pipeline
+         */
+        ParamAliases subAliases;
+
+        std::shared_ptr<const Pipeline<ComposeTask>> p_pipeline;
 
         ParamList inputSpecs, filterSpecs, consumeSpecs;
 
@@ -89,15 +100,37 @@ class ComposeAdaptTasks : public ComposeTask, public PipelineContainer<ComposeTa
         AdaptorPerAliases &operator=(const AdaptorPerAliases &) = default;
 
         AdaptorPerAliases(const ParamAliases &adaptorAliases, const ParamList &desiredOutputs,
-                          const ParamAliases &externalAliases,
-                          const MethodCollection &methodCollection, StringView friendlyName);
+                          const ParamAliases &externalAliases, ComponentRoot &root,
+                          StringView friendlyName);
     };
 
-    mutable StableMap<std::size_t, std::unique_ptr<AdaptorPerAliases>> m_adaptorPerSelectionHash;
-
-    const AdaptorPerAliases &getAdaptorPerAliases(const ParamAliases &externalAliases,
-                                                  const MethodCollection &methodCollection) const;
+    /**
+     * Guards the adaptor containers, since pipelines can be solved on another thread while the
+     * task runs. Users of an adaptor hold their own reference, so forgetting it is always safe
+     */
+    mutable std::mutex m_adaptorMutex;
+    mutable FlatHashMap<ParamAliases, std::shared_ptr<const AdaptorPerAliases>>
+        m_adaptorPerSelection;
+
+    /**
+     * Copies of the spec lists given to pipeline solvers, which reference them while solving.
+     * Unlike the adaptors they are never destroyed. Equal interned lists are kept only once
+     */
+    mutable FlatHashMap<std::size_t, std::vector<std::unique_ptr<const ParamList>>>
+        m_keptSpecListsPerHash;
+
+    std::shared_ptr<const AdaptorPerAliases> findAdaptorPerAliases(
+        const ParamAliases &externalAliases) const;
+    std::shared_ptr<const AdaptorPerAliases> getAdaptorPerAliases(
+        const ParamAliases &externalAliases, ComponentRoot &root) const;
+    std::shared_ptr<const AdaptorPerAliases> takeAdaptorPerAliases(
+        const ParamAliases &externalAliases) const;
     void forgetAdaptorPerAliases(const ParamAliases &externalAliases) const;
+
+    /**
+     * @returns A kept list equal to the specs, valid for the lifetime of the task
+     */
+    const ParamList &keepSpecList(const ParamList &specs) const;
 };
 
 struct ComposeAdaptTasksKeeperSeed {
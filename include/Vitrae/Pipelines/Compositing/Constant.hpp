@@ -28,6 +28,7 @@ class ComposeConstant : public ComposeTask
 
     void run(RenderComposeContext ctx) const override;
     void prepareRequiredLocalAssets(RenderComposeContext ctx) const override;
+    bool canRunConcurrently() const override;
 
     StringView getFriendlyName() const override;
 
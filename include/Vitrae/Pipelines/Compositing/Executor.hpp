@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Vitrae/Pipelines/Compositing/Task.hpp"
+#include "Vitrae/Pipelines/Pipeline.hpp"
+#include "Vitrae/Pipelines/TaskGraph.hpp"
+#include "Vitrae/Util/WorkStealingPool.hpp"
+
+namespace Vitrae
+{
+
+/**
+ * Runs the tasks of a compose pipeline, with the tasks that can run concurrently distributed over
+ * worker threads as soon as their dependencies finish.
+ * The remaining tasks run on the calling thread in pipeline order, so GPU submission and the
+ * pipeline memory see the same order as with sequential execution
+ * @note The properties of the context are accessed concurrently. Each slot is only accessed by
+ * tasks that are ordered by the task graph, so the scope needs no locking
+ */
+class ComposeExecutor
+{
+  public:
+    /**
+     * @param numWorkers The number of worker threads. Has to be at least 1
+     */
+    explicit ComposeExecutor(std::size_t numWorkers);
+
+    /**
+     * Runs all items of the pipeline and waits for them to finish
+     * @param graph The task graph of the pipeline, built with the context's aliases
+     * @throws The first exception thrown by a task. No new tasks are started after it, or after a
+     * task makes a request through ctx.requests
+     */
+    void run(const Pipeline<ComposeTask> &pipeline, const TaskGraph<ComposeTask> &graph,
+             RenderComposeContext ctx);
+
+    std::size_t getWorkerCount() const { return m_pool.getWorkerCount(); }
+
+  protected:
+    WorkStealingPool m_pool;
+};
+
+} // namespace Vitrae
\ No newline at end of file
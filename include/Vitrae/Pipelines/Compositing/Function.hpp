@@ -15,6 +15,7 @@ class ComposeFunction : public ComposeTask
     std::function<void(const RenderComposeContext &)> mp_function;
     String m_friendlyName;
     ParamList m_inputSpecs, m_outputSpecs, m_filterSpecs, m_consumingSpecs;
+    bool m_canRunConcurrently;
 
   public:
     struct SetupParams
@@ -25,6 +26,12 @@ class ComposeFunction : public ComposeTask
         ParamList consumingSpecs;
         std::function<void(const RenderComposeContext &)> p_function;
         String friendlyName;
+
+        /**
+         * Whether the function can run on a worker thread. Only enable if it doesn't submit GPU
+         * work and doesn't access properties outside of its specs
+         */
+        bool canRunConcurrently = false;
     };
 
     ComposeFunction(const SetupParams &params);
@@ -44,6 +51,7 @@ class ComposeFunction : public ComposeTask
 
     void run(RenderComposeContext ctx) const override;
     void prepareRequiredLocalAssets(RenderComposeContext ctx) const override;
+    bool canRunConcurrently() const override;
 
     StringView getFriendlyName() const override;
 };
@@ -44,6 +44,7 @@ class ComposeInitFunction : public ComposeTask
 
     void run(RenderComposeContext ctx) const override;
     void prepareRequiredLocalAssets(RenderComposeContext ctx) const override;
+    bool canRunConcurrently() const override;
 
     StringView getFriendlyName() const override;
 };
@@ -1,12 +1,16 @@
 #pragma once
 
 #include "Vitrae/Assets/Scene.hpp"
+#include "Vitrae/Data/Frustum.hpp"
 #include "Vitrae/Pipelines/Compositing/Task.hpp"
 #include "Vitrae/Setup/Rasterizing.hpp"
 
 #include "dynasma/keepers/abstract.hpp"
 
+#include <algorithm>
 #include <functional>
+#include <optional>
+#include <vector>
 
 namespace Vitrae
 {
@@ -30,8 +34,43 @@ class ComposeSceneRender : public ComposeTask
             std::function<std::pair<FilterFunc, SortFunc>(const Scene &scene,
                                                           const RenderComposeContext &ctx)>
                 generateFilterAndSort;
+
+            /**
+             * If set and returning a frustum, props outside of it are culled before filtering
+             */
+            std::function<std::optional<Frustum>(const Scene &scene,
+                                                 const RenderComposeContext &ctx)>
+                generateCullingFrustum;
         } ordering;
     };
+
+  protected:
+    /**
+     * Appends the props to render, culled by the scene's prop hierarchy if there is a frustum,
+     * and then filtered by the filter
+     */
+    static void collectRenderedProps(const Scene &scene, const std::optional<Frustum> &frustum,
+                                     const FilterFunc &filter,
+                                     std::vector<const ModelProp *> &outProps)
+    {
+        std::size_t firstCollected = outProps.size();
+
+        if (frustum.has_value()) {
+            scene.collectPropsInFrustum(frustum.value(), outProps);
+        } else {
+            for (const ModelProp &prop : scene.modelProps) {
+                outProps.push_back(&prop);
+            }
+        }
+
+        if (filter) {
+            auto itRemoved = std::remove_if(outProps.begin() + firstCollected, outProps.end(),
+                                            [&](const ModelProp *p_prop) {
+                                                return !filter(*p_prop);
+                                            });
+            outProps.erase(itRemoved, outProps.end());
+        }
+    }
 };
 
 struct ComposeSceneRenderKeeperSeed
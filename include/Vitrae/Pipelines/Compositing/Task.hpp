@@ -7,6 +7,8 @@
 #include "Vitrae/Pipelines/Task.hpp"
 #include "Vitrae/Pipelines/PipelineMemory.hpp"
 
+#include <atomic>
+
 namespace Vitrae
 {
 class Renderer;
@@ -27,16 +29,56 @@ class ComposeTaskException
 /**
  * Thrown if the requirements of the task have been changed while running and the pipeline needs to
  * be rebuilt
+ * @note Prefer ComposeRequests::requestRebuild(), which doesn't unwind the nested pipelines
  */
 class ComposeTaskRequirementsChangedException : public ComposeTaskException
 {};
 
+/**
+ * Requests from compose tasks to the runner of their pipeline, handled after the tasks return.
+ * Runners stop running further tasks once anything is requested, and handle all requests at once
+ * @note Thread safe
+ */
+class ComposeRequests
+{
+    std::atomic<bool> m_rebuildRequested = false;
+    std::atomic<bool> m_preparationRequested = false;
+
+  public:
+    /**
+     * Requests the pipeline to be rebuilt, because the requirements of the task have changed
+     */
+    void requestRebuild() { m_rebuildRequested.store(true, std::memory_order_relaxed); }
+
+    /**
+     * Requests the local assets to be prepared again without rebuilding the pipeline, i.e. because
+     * a frame store has to be resized
+     */
+    void requestPreparation() { m_preparationRequested.store(true, std::memory_order_relaxed); }
+
+    bool isRebuildRequested() const { return m_rebuildRequested.load(std::memory_order_relaxed); }
+
+    bool isPreparationRequested() const
+    {
+        return m_preparationRequested.load(std::memory_order_relaxed);
+    }
+
+    bool hasRequests() const { return isRebuildRequested() || isPreparationRequested(); }
+
+    void clear()
+    {
+        m_rebuildRequested.store(false, std::memory_order_relaxed);
+        m_preparationRequested.store(false, std::memory_order_relaxed);
+    }
+};
+
 struct RenderComposeContext
 {
     ArgumentScope &properties;
     ComponentRoot &root;
     const ParamAliases &aliases;
     PipelineMemory &pipelineMemory;
+    ComposeRequests &requests;
 };
 
 class ComposeTask : public Task
@@ -50,9 +92,17 @@ class ComposeTask : public Task
 
     /**
      * Execute the task
-     * @throws ComposeTaskRequirementsChangedException if the pipeline needs to be rebuilt
+     * @note Request a rebuild through ctx.requests if the pipeline needs to be rebuilt
      */
     virtual void run(RenderComposeContext ctx) const = 0;
+
+    /**
+     * @returns Whether run() can be called from a worker thread, concurrently with tasks that
+     * don't access the same properties
+     * @note Such tasks may only access properties from their specs and must not submit GPU work or
+     * use the pipeline memory. Other tasks run on the compositor's thread in pipeline order
+     */
+    virtual bool canRunConcurrently() const { return false; }
 };
 
 } // namespace Vitrae
\ No newline at end of file
@@ -1,8 +1,19 @@
 #pragma once
 
+#include "Vitrae/Containers/FlatHashMap.hpp"
+#include "Vitrae/Containers/FlatHashSet.hpp"
+#include "Vitrae/Params/ParamSlotTable.hpp"
 #include "Vitrae/Pipelines/Method.hpp"
-
+#include "Vitrae/Util/Hashing.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
 #include <stdexcept>
+#include <vector>
 
 namespace Vitrae
 {
@@ -41,41 +52,25 @@ template <TaskChild BasicTask> class Pipeline
     Pipeline(dynasma::FirmPtr<const Method<BasicTask>> p_method,
              const ParamList &desiredOutputSpecs, const ParamAliases &selection)
     {
-        std::map<StringId, String> wipUsedSelection;
+        std::array<std::byte, SOLVER_ARENA_SIZE> arenaBuffer;
+        std::pmr::monotonic_buffer_resource arena(arenaBuffer.data(), arenaBuffer.size());
+        SolverScratch scratch(&arena);
 
         // desired spec aliases (optimization and later setup)
-        ParamList actualDesiredOutputSpecs;
-        for (auto &outputSpec : desiredOutputSpecs.getSpecList()) {
-            String choiceStr = selection.choiceStringFor(outputSpec.name);
-            if (choiceStr != outputSpec.name) {
-                wipUsedSelection[outputSpec.name] = choiceStr;
-            }
-            actualDesiredOutputSpecs.insert_back({
-                .name = choiceStr,
-                .typeInfo = outputSpec.typeInfo,
-                .defaultValue = outputSpec.defaultValue,
-            });
-        }
+        ParamList actualDesiredOutputSpecs =
+            getActualDesiredOutputSpecs(desiredOutputSpecs, selection, scratch);
+        outputAliasKeys.assign(desiredOutputSpecs.getSpecNameIds().begin(),
+                               desiredOutputSpecs.getSpecNameIds().end());
 
         // solve dependencies
-        std::set<StringId> visitedOutputs;
         for (auto &outputSpec : actualDesiredOutputSpecs.getSpecList()) {
-            tryAddDependency(outputSpec, *p_method, visitedOutputs, selection, wipUsedSelection);
+            addDependency(outputSpec, *p_method, selection, scratch);
         }
 
         // Process tasks' properties and add them to the pipeline
-        setupPropertiesFromTasks(actualDesiredOutputSpecs, selection);
-
-        // Add used selections
-        for (auto p_specs : {&inputSpecs, &outputSpecs, &filterSpecs, &consumingSpecs}) {
-            for (auto &spec : p_specs->getSpecList()) {
-                String choiceStr = selection.choiceStringFor(spec.name);
-                if (choiceStr != spec.name) {
-                    wipUsedSelection[spec.name] = choiceStr;
-                }
-            }
-        }
-        usedSelection = ParamAliases(StableMap<StringId, String>(std::move(wipUsedSelection)));
+        setupPropertiesFromTasks(actualDesiredOutputSpecs, selection, &arena);
+        setupSlotsFromTasks(selection);
+        setupUsedSelection(selection, scratch);
     }
 
     /**
@@ -94,46 +89,30 @@ template <TaskChild BasicTask> class Pipeline
              PipelineParametrizationPolicy parametrizationPolicy,
              const ParamList &desiredOutputSpecs, const ParamAliases &selection)
     {
-        std::map<StringId, String> wipUsedSelection;
+        std::array<std::byte, SOLVER_ARENA_SIZE> arenaBuffer;
+        std::pmr::monotonic_buffer_resource arena(arenaBuffer.data(), arenaBuffer.size());
+        SolverScratch scratch(&arena);
 
         // desired spec aliases (optimization and later setup)
-        ParamList actualDesiredOutputSpecs;
-        for (auto &outputSpec : desiredOutputSpecs.getSpecList()) {
-            String choiceStr = selection.choiceStringFor(outputSpec.name);
-            if (choiceStr != outputSpec.name) {
-                wipUsedSelection[outputSpec.name] = choiceStr;
-            }
-            actualDesiredOutputSpecs.insert_back({
-                .name = choiceStr,
-                .typeInfo = outputSpec.typeInfo,
-                .defaultValue = outputSpec.defaultValue,
-            });
-        }
+        ParamList actualDesiredOutputSpecs =
+            getActualDesiredOutputSpecs(desiredOutputSpecs, selection, scratch);
+        outputAliasKeys.assign(desiredOutputSpecs.getSpecNameIds().begin(),
+                               desiredOutputSpecs.getSpecNameIds().end());
 
         // solve dependencies
-        std::set<StringId> visitedOutputs;
         for (auto &nameId : parametricInputIds) {
-            visitedOutputs.insert(nameId);
+            scratch.visitedOutputs.insert(nameId);
         }
 
         for (auto &outputSpec : actualDesiredOutputSpecs.getSpecList()) {
-            tryAddDependencyIfParametrized(outputSpec, *p_method, visitedOutputs,
-                                           parametrizationPolicy, selection, wipUsedSelection);
+            addDependencyIfParametrized(outputSpec, *p_method, parametrizationPolicy, selection,
+                                        scratch);
         }
 
         // Process tasks' properties and add them to the pipeline
-        setupPropertiesFromTasks(actualDesiredOutputSpecs, selection);
-
-        // Add used selections
-        for (auto p_specs : {&inputSpecs, &outputSpecs, &filterSpecs, &consumingSpecs}) {
-            for (auto &spec : p_specs->getSpecList()) {
-                String choiceStr = selection.choiceStringFor(spec.name);
-                if (choiceStr != spec.name) {
-                    wipUsedSelection[spec.name] = choiceStr;
-                }
-            }
-        }
-        usedSelection = ParamAliases(wipUsedSelection);
+        setupPropertiesFromTasks(actualDesiredOutputSpecs, selection, &arena);
+        setupSlotsFromTasks(selection);
+        setupUsedSelection(selection, scratch);
     }
 
     /**
@@ -181,57 +160,230 @@ template <TaskChild BasicTask> class Pipeline
      */
     ParamList localSpecs;
 
+    /**
+     * Slots of all properties used by the pipeline, resolved with the pipeline's aliases
+     */
+    ParamSlotTable slots;
+
+    /**
+     * Names of the desired outputs, before aliasing
+     */
+    std::vector<StringId> outputAliasKeys;
+
+    /**
+     * Names of the properties each item was chosen and connected by, before aliasing.
+     * In the same order as the items
+     * @note The item stays valid for other aliases as long as these names are aliased the same
+     */
+    std::vector<std::vector<StringId>> itemAliasKeys;
+
+    /**
+     * Identifies the pipeline by its tasks, their order and the properties connecting them.
+     * Computed while solving, so it can key caches of pipeline products without comparing them
+     * @note Hashes the addresses of the tasks, so it only identifies pipelines within the process.
+     * Pipelines contained in the tasks aren't included
+     */
+    std::uint64_t fingerprint = 0;
+
+    /**
+     * @returns Whether the desired outputs are aliased differently in the new selection
+     */
+    bool areOutputsAffectedByAliasChange(const ParamAliases &oldSelection,
+                                         const ParamAliases &newSelection) const
+    {
+        return isAnyAliasChanged(outputAliasKeys, oldSelection, newSelection);
+    }
+
+    /**
+     * @returns Whether the item depends on a property aliased differently in the new selection
+     * @note Pipelines contained in the item aren't checked
+     */
+    bool isItemAffectedByAliasChange(std::size_t itemIndex, const ParamAliases &oldSelection,
+                                     const ParamAliases &newSelection) const
+    {
+        return isAnyAliasChanged(itemAliasKeys[itemIndex], oldSelection, newSelection);
+    }
+
   protected:
+    static bool isAnyAliasChanged(std::span<const StringId> keys, const ParamAliases &oldSelection,
+                                  const ParamAliases &newSelection)
+    {
+        return std::any_of(keys.begin(), keys.end(), [&](StringId key) {
+            return oldSelection.choiceFor(key) != newSelection.choiceFor(key);
+        });
+    }
+
+    /**
+     * Size of the solver's scratch space on the stack. Bigger pipelines continue in heap blocks
+     */
+    static constexpr std::size_t SOLVER_ARENA_SIZE = 16 * 1024;
+
+    /**
+     * A task whose dependencies are being solved
+     */
+    struct DependencyFrame
+    {
+        dynasma::FirmPtr<BasicTask> p_task;
+
+        /**
+         * The input, filter and consuming specs of the task
+         */
+        std::array<const StableMap<StringId, ParamSpec> *, 3> p_dependencyLists;
+        std::size_t listIndex;
+        std::size_t specIndex;
+
+        PipelineParametrizationPolicy parametrizationPolicy;
+        bool satisfiedAnyDependencies;
+
+        DependencyFrame(dynasma::FirmPtr<BasicTask> p_task,
+                        PipelineParametrizationPolicy parametrizationPolicy,
+                        const ParamAliases &selection)
+            : p_task(p_task),
+              p_dependencyLists{&p_task->getInputSpecs(selection).getMappedSpecs(),
+                                &p_task->getFilterSpecs(selection).getMappedSpecs(),
+                                &p_task->getConsumingSpecs(selection).getMappedSpecs()},
+              listIndex(0), specIndex(0), parametrizationPolicy(parametrizationPolicy),
+              satisfiedAnyDependencies(false)
+        {}
+
+        /**
+         * @returns The next dependency's name and spec, or nullptr as the spec if all were visited
+         */
+        std::pair<StringId, const ParamSpec *> nextDependency()
+        {
+            while (listIndex < p_dependencyLists.size()) {
+                const auto &specs = *p_dependencyLists[listIndex];
+                if (specIndex < specs.size()) {
+                    auto [nameId, spec] = *(specs.begin() + specIndex);
+                    ++specIndex;
+                    return {nameId, &spec};
+                }
+                ++listIndex;
+                specIndex = 0;
+            }
+            return {StringId(""), nullptr};
+        }
+    };
+
+    /**
+     * State of the dependency solver, allocated from an arena
+     */
+    struct SolverScratch
+    {
+        FlatHashSet<StringId> visitedOutputs;
+        FlatHashSet<StringId> usedProxySet;
+        std::pmr::vector<StringId> usedProxies;
+        std::pmr::vector<DependencyFrame> stack;
+
+        SolverScratch(std::pmr::memory_resource *p_arena)
+            : visitedOutputs(p_arena), usedProxySet(p_arena), usedProxies(p_arena),
+              stack(p_arena)
+        {}
+
+        /**
+         * Marks the proxy as used by the pipeline, so it ends up in the usedSelection
+         */
+        void useProxy(StringId proxy)
+        {
+            if (usedProxySet.insert(proxy)) {
+                usedProxies.push_back(proxy);
+            }
+        }
+    };
+
+    /**
+     * @returns The desired output specs, renamed to their chosen providers
+     */
+    static ParamList getActualDesiredOutputSpecs(const ParamList &desiredOutputSpecs,
+                                                 const ParamAliases &selection,
+                                                 SolverScratch &scratch)
+    {
+        ParamList actualDesiredOutputSpecs;
+        for (auto &outputSpec : desiredOutputSpecs.getSpecList()) {
+            String choiceStr = selection.choiceStringFor(outputSpec.name);
+            if (choiceStr != outputSpec.name) {
+                scratch.useProxy(outputSpec.name);
+            }
+            actualDesiredOutputSpecs.insert_back({
+                .name = choiceStr,
+                .typeInfo = outputSpec.typeInfo,
+                .defaultValue = outputSpec.defaultValue,
+            });
+        }
+        return actualDesiredOutputSpecs;
+    }
+
     /**
-     * Adds the desiredOutputSpec name to the visitedOutputs set.
+     * Sets the usedSelection to the aliases of all proxies used in the pipeline
+     */
+    void setupUsedSelection(const ParamAliases &selection, SolverScratch &scratch)
+    {
+        for (auto p_specs : {&inputSpecs, &outputSpecs, &filterSpecs, &consumingSpecs}) {
+            for (auto nameId : p_specs->getSpecNameIds()) {
+                if (selection.choiceFor(nameId) != nameId) {
+                    scratch.useProxy(nameId);
+                }
+            }
+        }
+        usedSelection = selection.subset(scratch.usedProxies);
+    }
+
+    /**
+     * Adds the desiredOutputSpec name to the visited outputs.
      * Adds a task outputting the desired property if possible and all its dependency properties.
-     * If a task is added, all its outputs are added to the visitedOutputs set
+     * If a task is added, all its outputs are added to the visited outputs
+     * @note The dependencies are solved depth-first without recursion. Tasks are added after
+     * their dependencies
      * @param desiredOutputSpec The dependency property
      * @param method The method we use to get the task
-     * @param visitedOutputs The set of visited outputs
      * @param selection The property mapping
-     * @param outUsedSelection The used property mapping
+     * @param scratch The solver state, including the visited outputs and used proxies
      */
-    void tryAddDependency(const ParamSpec &desiredOutputSpec, const Method<BasicTask> &method,
-                          std::set<StringId> &visitedOutputs, const ParamAliases &selection,
-                          std::map<StringId, String> &outUsedSelection)
+    void addDependency(const ParamSpec &desiredOutputSpec, const Method<BasicTask> &method,
+                       const ParamAliases &selection, SolverScratch &scratch)
     {
-        String actualOutputName = selection.choiceStringFor(desiredOutputSpec.name);
+        // pushes the task for the property, if it needs to be added
+        auto visit = [&](StringId nameId) {
+            StringId actualNameId = selection.choiceFor(nameId);
 
-        if (actualOutputName != desiredOutputSpec.name) {
-            outUsedSelection[desiredOutputSpec.name] = actualOutputName;
-        }
+            if (actualNameId != nameId) {
+                scratch.useProxy(nameId);
+            }
 
-        if (visitedOutputs.find(actualOutputName) == visitedOutputs.end()) {
-            std::optional<dynasma::FirmPtr<BasicTask>> maybeTask = method.getTask(actualOutputName);
+            if (!scratch.visitedOutputs.contains(actualNameId)) {
+                std::optional<dynasma::FirmPtr<BasicTask>> maybeTask = method.getTask(actualNameId);
 
-            if (maybeTask.has_value()) {
-                const Task &task = *maybeTask.value();
+                if (maybeTask.has_value()) {
+                    // task outputs (store the outputs as visited)
+                    for (auto outputNameId : maybeTask.value()->getOutputSpecs().getSpecNameIds()) {
+                        scratch.visitedOutputs.insert(outputNameId);
+                    }
 
-                // task outputs (store the outputs as visited)
-                for (auto [nameId, spec] : task.getOutputSpecs().getMappedSpecs()) {
-                    visitedOutputs.insert(nameId);
+                    scratch.stack.emplace_back(maybeTask.value(),
+                                               PipelineParametrizationPolicy::AllDependencies,
+                                               selection);
+                } else {
+                    scratch.visitedOutputs.insert(actualNameId);
                 }
+            }
+        };
 
-                // task deps (input + filter + consuming)
-                for (auto [nameId, spec] : task.getInputSpecs(selection).getMappedSpecs()) {
-                    tryAddDependency(spec, method, visitedOutputs, selection, outUsedSelection);
-                }
-                for (auto [nameId, spec] : task.getFilterSpecs(selection).getMappedSpecs()) {
-                    tryAddDependency(spec, method, visitedOutputs, selection, outUsedSelection);
-                }
-                for (auto [nameId, spec] : task.getConsumingSpecs(selection).getMappedSpecs()) {
-                    tryAddDependency(spec, method, visitedOutputs, selection, outUsedSelection);
-                }
+        visit(desiredOutputSpec.name);
+
+        while (!scratch.stack.empty()) {
+            DependencyFrame &frame = scratch.stack.back();
 
+            // task deps (input + filter + consuming)
+            if (auto [nameId, p_spec] = frame.nextDependency(); p_spec) {
+                visit(nameId);
+            } else {
                 // consume specs by removing them from the visited list
-                for (auto [nameId, spec] : task.getConsumingSpecs(selection).getMappedSpecs()) {
-                    visitedOutputs.erase(nameId);
+                for (auto [nameId, spec] : *frame.p_dependencyLists[2]) {
+                    scratch.visitedOutputs.erase(nameId);
                 }
 
-                items.push_back(maybeTask.value());
-            } else {
-                visitedOutputs.insert(actualOutputName);
+                items.push_back(frame.p_task);
+                scratch.stack.pop_back();
             }
         }
     };
@@ -239,108 +391,137 @@ template <TaskChild BasicTask> class Pipeline
     /**
      * Adds a task outputting the desired property if possible and all its dependency properties,
      * but only if it directly or indirectly depends on one of already visited outputs.
-     * If a task is added, all its outputs are added to the visitedOutputs set.
+     * If a task is added, all its outputs are added to the visited outputs.
      * If policy==AllDependencies; then even non-parametrized dependencies are added;
      * If policy==ParametrizedOrDirectDependencies; then this dependency is added even if it is
      * non-parametrized, but its dependencies are added with policy=ParametrizedDependencies;
      * If policy==ParametrizedDependencies; then only parametrized dependencies are added.
+     * @note The dependencies are solved depth-first without recursion. Tasks are added after
+     * their dependencies
      * @param desiredOutputSpec The dependency property
      * @param method The method we use to get the task
-     * @param visitedOutputs The set of visited outputs
      * @param parametrizationPolicy The parametrization policy
      * @param selection The property mapping
-     * @param outUsedSelection The used property mapping
+     * @param scratch The solver state, including the visited outputs and used proxies
      * @returns Whether the dependency is satisfied
+     * @throws PipelineSetupException if a task depends on its own output
      */
-    bool tryAddDependencyIfParametrized(const ParamSpec &desiredOutputSpec,
-                                        const Method<BasicTask> &method,
-                                        std::set<StringId> &visitedOutputs,
-                                        PipelineParametrizationPolicy parametrizationPolicy,
-                                        const ParamAliases &selection,
-                                        std::map<StringId, String> &outUsedSelection)
+    bool addDependencyIfParametrized(const ParamSpec &desiredOutputSpec,
+                                     const Method<BasicTask> &method,
+                                     PipelineParametrizationPolicy parametrizationPolicy,
+                                     const ParamAliases &selection, SolverScratch &scratch)
     {
-        String actualOutputName = selection.choiceStringFor(desiredOutputSpec.name);
+        // returns whether the property is satisfied,
+        // or empty if the task for it was pushed and the result is pending
+        auto visit = [&](StringId nameId, const ParamSpec &spec,
+                         PipelineParametrizationPolicy policy) -> std::optional<bool> {
+            StringId actualNameId = selection.choiceFor(nameId);
+
+            if (actualNameId != nameId) {
+                scratch.useProxy(nameId);
+            }
 
-        if (actualOutputName != desiredOutputSpec.name) {
-            outUsedSelection[desiredOutputSpec.name] = actualOutputName;
-        }
+            if (scratch.visitedOutputs.contains(nameId) ||
+                scratch.visitedOutputs.contains(actualNameId)) {
+                return true;
+            }
 
-        if (visitedOutputs.find(desiredOutputSpec.name) != visitedOutputs.end() ||
-            visitedOutputs.find(actualOutputName) != visitedOutputs.end()) {
-            return true;
-        }
+            std::optional<dynasma::FirmPtr<BasicTask>> maybeTask = method.getTask(actualNameId);
 
-        std::optional<dynasma::FirmPtr<BasicTask>> maybeTask = method.getTask(actualOutputName);
+            if (!maybeTask.has_value()) {
+                return false;
+            }
 
-        if (maybeTask.has_value()) {
-            const Task &task = *maybeTask.value();
+            // outputs aren't visited before the task is added, so cycles have to be detected
+            for (const DependencyFrame &frame : scratch.stack) {
+                if (&*frame.p_task == &*maybeTask.value()) {
+                    throw PipelineSetupException(
+                        String("Task '") + String(frame.p_task->getFriendlyName()) +
+                        "' depends on its own output '" + selection.choiceStringFor(spec.name) +
+                        "'");
+                }
+            }
 
-            bool satisfiedAnyDependencies = false;
-            PipelineParametrizationPolicy indirectDepPolicy =
-                parametrizationPolicy == PipelineParametrizationPolicy::AllDependencies
-                    ? PipelineParametrizationPolicy::AllDependencies
-                    : PipelineParametrizationPolicy::ParametrizedDependencies;
+            scratch.stack.emplace_back(maybeTask.value(), policy, selection);
+            return std::nullopt;
+        };
 
-            // task deps (input + filter + consuming)
-            for (auto [nameId, spec] : task.getInputSpecs(selection).getMappedSpecs()) {
-                satisfiedAnyDependencies |= tryAddDependencyIfParametrized(
-                    spec, method, visitedOutputs, indirectDepPolicy, selection, outUsedSelection);
-            }
-            for (auto [nameId, spec] : task.getFilterSpecs(selection).getMappedSpecs()) {
-                satisfiedAnyDependencies |= tryAddDependencyIfParametrized(
-                    spec, method, visitedOutputs, indirectDepPolicy, selection, outUsedSelection);
-            }
-            for (auto [nameId, spec] : task.getConsumingSpecs(selection).getMappedSpecs()) {
-                satisfiedAnyDependencies |= tryAddDependencyIfParametrized(
-                    spec, method, visitedOutputs, indirectDepPolicy, selection, outUsedSelection);
-            }
+        std::optional<bool> satisfied =
+            visit(desiredOutputSpec.name, desiredOutputSpec, parametrizationPolicy);
 
-            if (satisfiedAnyDependencies ||
-                parametrizationPolicy != PipelineParametrizationPolicy::ParametrizedDependencies) {
+        while (!scratch.stack.empty()) {
+            DependencyFrame &frame = scratch.stack.back();
 
-                // task outputs (store the outputs as visited)
-                for (auto [nameId, spec] : task.getOutputSpecs().getMappedSpecs()) {
-                    visitedOutputs.insert(nameId);
+            // task deps (input + filter + consuming)
+            if (auto [nameId, p_spec] = frame.nextDependency(); p_spec) {
+                PipelineParametrizationPolicy indirectDepPolicy =
+                    frame.parametrizationPolicy == PipelineParametrizationPolicy::AllDependencies
+                        ? PipelineParametrizationPolicy::AllDependencies
+                        : PipelineParametrizationPolicy::ParametrizedDependencies;
+
+                // frame stays valid if nothing was pushed
+                if (std::optional<bool> depSatisfied = visit(nameId, *p_spec, indirectDepPolicy);
+                    depSatisfied.has_value()) {
+                    frame.satisfiedAnyDependencies |= depSatisfied.value();
                 }
-
-                // consume specs by removing them from the visited list
-                for (auto [nameId, spec] : task.getConsumingSpecs(selection).getMappedSpecs()) {
-                    visitedOutputs.erase(nameId);
+            } else {
+                bool added = frame.satisfiedAnyDependencies ||
+                             frame.parametrizationPolicy !=
+                                 PipelineParametrizationPolicy::ParametrizedDependencies;
+
+                if (added) {
+                    // task outputs (store the outputs as visited)
+                    for (auto outputNameId : frame.p_task->getOutputSpecs().getSpecNameIds()) {
+                        scratch.visitedOutputs.insert(outputNameId);
+                    }
+
+                    // consume specs by removing them from the visited list
+                    for (auto [nameId, spec] : *frame.p_dependencyLists[2]) {
+                        scratch.visitedOutputs.erase(nameId);
+                    }
+
+                    items.push_back(frame.p_task);
                 }
 
-                items.push_back(maybeTask.value());
+                scratch.stack.pop_back();
 
-                return true;
+                if (scratch.stack.empty()) {
+                    satisfied = added;
+                } else {
+                    scratch.stack.back().satisfiedAnyDependencies |= added;
+                }
             }
         }
 
-        return false;
+        return satisfied.value();
     }
 
     /**
      * Adds all used properties in the pipeline's tasks to the correct ParamLists.
      * (i.e this->inputSpecs, this->outputSpecs, this->filterSpecs, this->consumedSpecs,
      * this->pipethroughSpecs, this->localSpecs)
-     * @param fixedInputSpecs The known input specs
      * @param desiredOutputSpecs The desired output specs
      * @param selection The property mapping
+     * @param p_arena The memory resource for temporary sets
      */
     void setupPropertiesFromTasks(const ParamList &desiredOutputSpecs,
-                                  const ParamAliases &selection)
+                                  const ParamAliases &selection,
+                                  std::pmr::memory_resource *p_arena)
     {
         // 4 maps/sets needed to know how we use properties
-        std::set<StringId> missingPropertyNames;
-        std::map<StringId, ParamSpec> everUsedProperties;
-        std::set<StringId> currentPropertyNames;
-        std::set<StringId> modifiedPropertyNames;
+        // everUsedProperties maps the actual names to the first spec using them
+        FlatHashSet<StringId> missingPropertyNames(p_arena);
+        FlatHashMap<StringId, const ParamSpec *> everUsedProperties(p_arena);
+        FlatHashSet<StringId> currentPropertyNames(p_arena);
+        FlatHashSet<StringId> modifiedPropertyNames(p_arena);
 
         // helper functions for controlling the maps/sets
 
-        auto requireProperty = [&](const ParamSpec &propertySpec) {
-            StringId actualName = selection.choiceFor(propertySpec.name);
+        auto requireProperty = [&](StringId nameId, const ParamSpec &propertySpec) {
+            StringId actualName = selection.choiceFor(nameId);
 
-            if (currentPropertyNames.find(actualName) == currentPropertyNames.end()) {
-                if (everUsedProperties.find(actualName) == everUsedProperties.end()) {
+            if (!currentPropertyNames.contains(actualName)) {
+                if (!everUsedProperties.contains(actualName)) {
                     missingPropertyNames.insert(actualName);
                     currentPropertyNames.insert(actualName);
                 } else {
@@ -351,86 +532,124 @@ template <TaskChild BasicTask> class Pipeline
             }
         };
 
-        auto usingProperty = [&](const ParamSpec &propertySpec, const String &byWho) {
-            String actualName = selection.choiceStringFor(propertySpec.name);
-            ParamSpec actualSpec = {
-                .name = actualName,
-                .typeInfo = propertySpec.typeInfo,
-                .defaultValue = propertySpec.defaultValue,
-            };
-
-            auto it = everUsedProperties.find(actualName);
-            if (it != everUsedProperties.end()) {
-                if ((*it).second.typeInfo != propertySpec.typeInfo) {
-                    throw PipelineSetupException(
-                        String("Property '") + actualSpec.name + "' was first used as " +
-                        String((*it).second.typeInfo.getShortTypeName()) + " but later as " +
-                        String(propertySpec.typeInfo.getShortTypeName()) + " by " + byWho);
-                }
-            } else {
-                everUsedProperties.emplace(actualName, actualSpec);
+        // byWho is the task using the property, or nullptr for the pipeline outputs
+        auto usingProperty = [&](StringId nameId, const ParamSpec &propertySpec,
+                                 const Task *p_byWho) {
+            StringId actualName = selection.choiceFor(nameId);
+
+            auto [it, inserted] = everUsedProperties.emplace(actualName, &propertySpec);
+            if (!inserted && (*it).second->typeInfo != propertySpec.typeInfo) {
+                String byWho = p_byWho ? "task '" + String(p_byWho->getFriendlyName()) + "'"
+                                       : String("pipeline outputs");
+                throw PipelineSetupException(
+                    String("Property '") + selection.choiceStringFor(propertySpec.name) +
+                    "' was first used as " +
+                    String((*it).second->typeInfo.getShortTypeName()) + " but later as " +
+                    String(propertySpec.typeInfo.getShortTypeName()) + " by " + byWho);
             }
         };
 
-        auto setProperty = [&](const ParamSpec &propertySpec) {
-            StringId actualName = selection.choiceFor(propertySpec.name);
+        auto setProperty = [&](StringId nameId) {
+            StringId actualName = selection.choiceFor(nameId);
 
             modifiedPropertyNames.insert(actualName);
             currentPropertyNames.insert(actualName);
         };
 
-        auto consumeProperty = [&](const ParamSpec &propertySpec) {
-            StringId actualName = selection.choiceFor(propertySpec.name);
+        auto consumeProperty = [&](StringId nameId) {
+            StringId actualName = selection.choiceFor(nameId);
 
             currentPropertyNames.erase(actualName);
         };
 
         // iterate over the tasks and simulate property usage
+        StreamingHash fingerprintHash;
+        itemAliasKeys.reserve(items.size());
         for (auto &p_item : items) {
             const Task &task = *p_item;
-            String taskContextName = "task '" + String(task.getFriendlyName()) + "'";
+            std::vector<StringId> &aliasKeys = itemAliasKeys.emplace_back();
+            fingerprintHash.add(reinterpret_cast<std::uintptr_t>(&task));
+
+            const ParamList &taskInputSpecs = task.getInputSpecs(selection);
+            for (std::size_t i = 0; i < taskInputSpecs.count(); ++i) {
+                const ParamSpec &spec = taskInputSpecs.getSpecList()[i];
+                StringId nameId = taskInputSpecs.getSpecNameIds()[i];
+                aliasKeys.push_back(nameId);
+                requireProperty(nameId, spec);
+                usingProperty(nameId, spec, &task);
+            }
 
-            for (auto &spec : task.getInputSpecs(selection).getSpecList()) {
-                requireProperty(spec);
-                usingProperty(spec, taskContextName);
+            const ParamList &taskConsumingSpecs = task.getConsumingSpecs(selection);
+            for (std::size_t i = 0; i < taskConsumingSpecs.count(); ++i) {
+                const ParamSpec &spec = taskConsumingSpecs.getSpecList()[i];
+                StringId nameId = taskConsumingSpecs.getSpecNameIds()[i];
+                aliasKeys.push_back(nameId);
+                requireProperty(nameId, spec);
+                usingProperty(nameId, spec, &task);
+                consumeProperty(nameId);
             }
 
-            for (auto &spec : task.getConsumingSpecs(selection).getSpecList()) {
-                requireProperty(spec);
-                usingProperty(spec, taskContextName);
-                consumeProperty(spec);
+            const ParamList &taskOutputSpecs = task.getOutputSpecs();
+            for (std::size_t i = 0; i < taskOutputSpecs.count(); ++i) {
+                const ParamSpec &spec = taskOutputSpecs.getSpecList()[i];
+                StringId nameId = taskOutputSpecs.getSpecNameIds()[i];
+                aliasKeys.push_back(nameId);
+                usingProperty(nameId, spec, &task);
+                setProperty(nameId);
             }
 
-            for (auto &spec : task.getOutputSpecs().getSpecList()) {
-                usingProperty(spec, taskContextName);
-                setProperty(spec);
+            const ParamList &taskFilterSpecs = task.getFilterSpecs(selection);
+            for (std::size_t i = 0; i < taskFilterSpecs.count(); ++i) {
+                const ParamSpec &spec = taskFilterSpecs.getSpecList()[i];
+                StringId nameId = taskFilterSpecs.getSpecNameIds()[i];
+                aliasKeys.push_back(nameId);
+                requireProperty(nameId, spec);
+                usingProperty(nameId, spec, &task);
+                setProperty(nameId);
             }
 
-            for (auto &spec : task.getFilterSpecs(selection).getSpecList()) {
-                requireProperty(spec);
-                usingProperty(spec, taskContextName);
-                setProperty(spec);
+            // the chosen names of the task's properties identify how it is connected
+            for (StringId nameId : aliasKeys) {
+                fingerprintHash.add(std::hash<StringId>{}(selection.choiceFor(nameId)));
             }
         }
 
         // also use the desired outputs, even if not used by the tasks
-        for (auto &spec : desiredOutputSpecs.getSpecList()) {
-            requireProperty(spec);
-            usingProperty(spec, "pipeline outputs");
+        for (std::size_t i = 0; i < desiredOutputSpecs.count(); ++i) {
+            const ParamSpec &spec = desiredOutputSpecs.getSpecList()[i];
+            StringId nameId = desiredOutputSpecs.getSpecNameIds()[i];
+            requireProperty(nameId, spec);
+            usingProperty(nameId, spec, nullptr);
+            fingerprintHash.add(std::hash<StringId>{}(nameId));
+        }
+        fingerprint = fingerprintHash.get();
+
+        // the lists are filled in the order of the names, so they are the same for every build
+        std::pmr::vector<std::pair<StringId, const ParamSpec *>> sortedUsedProperties(p_arena);
+        sortedUsedProperties.reserve(everUsedProperties.size());
+        for (auto [nameId, p_spec] : everUsedProperties) {
+            sortedUsedProperties.emplace_back(nameId, p_spec);
         }
+        std::sort(sortedUsedProperties.begin(), sortedUsedProperties.end(),
+                  [](const auto &a, const auto &b) { return a.first < b.first; });
 
         // analyze the sets and add property specs to proper lists
-        for (auto &[nameId, spec] : everUsedProperties) {
-            if (missingPropertyNames.find(nameId) != missingPropertyNames.end()) {
+        for (auto &[nameId, p_firstSpec] : sortedUsedProperties) {
+            ParamSpec spec = {
+                .name = selection.choiceStringFor(p_firstSpec->name),
+                .typeInfo = p_firstSpec->typeInfo,
+                .defaultValue = p_firstSpec->defaultValue,
+            };
+
+            if (missingPropertyNames.contains(nameId)) {
                 // property  existed beforehand
-                if (currentPropertyNames.find(nameId) == currentPropertyNames.end()) {
+                if (!currentPropertyNames.contains(nameId)) {
                     // property was consumed at some point
                     consumingSpecs.insert_back(spec);
-                } else if (modifiedPropertyNames.find(nameId) != modifiedPropertyNames.end()) {
+                } else if (modifiedPropertyNames.contains(nameId)) {
                     // property was modified and still exists
                     filterSpecs.insert_back(spec);
-                } else if (desiredOutputSpecs.getMappedSpecs().find(nameId) !=
-                           desiredOutputSpecs.getMappedSpecs().end()) {
+                } else if (desiredOutputSpecs.contains(nameId)) {
                     // property was desired and but only set externally
                     pipethroughSpecs.insert_back(spec);
                 } else {
@@ -439,8 +658,7 @@ template <TaskChild BasicTask> class Pipeline
                 }
             } else {
                 // property was introduced by the pipeline
-                if (desiredOutputSpecs.getMappedSpecs().find(nameId) !=
-                    desiredOutputSpecs.getMappedSpecs().end()) {
+                if (desiredOutputSpecs.contains(nameId)) {
                     // property was desired and is set by the pipeline
                     outputSpecs.insert_back(spec);
                 } else {
@@ -449,6 +667,41 @@ template <TaskChild BasicTask> class Pipeline
                 }
             }
         }
+
+        // the lists are kept for as long as the pipeline, and compared by the owning tasks
+        for (auto p_specs : {&inputSpecs, &outputSpecs, &filterSpecs, &consumingSpecs,
+                             &pipethroughSpecs, &localSpecs}) {
+            p_specs->intern();
+        }
+    }
+
+    /**
+     * Assigns slots to all properties in the spec lists, and maps the names requested by the
+     * tasks to them
+     * @param selection The property mapping
+     */
+    void setupSlotsFromTasks(const ParamAliases &selection)
+    {
+        slots = ParamSlotTable();
+
+        for (auto p_specs : {&inputSpecs, &outputSpecs, &filterSpecs, &consumingSpecs,
+                             &pipethroughSpecs, &localSpecs}) {
+            for (auto nameId : p_specs->getSpecNameIds()) {
+                slots.addSlot(nameId);
+            }
+        }
+
+        for (auto &p_item : items) {
+            const Task &task = *p_item;
+
+            for (auto p_specs : {&task.getInputSpecs(selection), &task.getOutputSpecs(),
+                                 &task.getFilterSpecs(selection),
+                                 &task.getConsumingSpecs(selection)}) {
+                for (auto nameId : p_specs->getSpecNameIds()) {
+                    slots.addRequestedName(nameId, selection.choiceFor(nameId));
+                }
+            }
+        }
     }
 };
 } // namespace Vitrae
\ No newline at end of file
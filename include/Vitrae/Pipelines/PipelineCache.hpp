@@ -0,0 +1,282 @@
+#pragma once
+
+#include "Vitrae/Containers/FlatHashMap.hpp"
+#include "Vitrae/Pipelines/Pipeline.hpp"
+#include "Vitrae/Util/Hashing.hpp"
+
+#include "dynasma/pointer.hpp"
+
+#include <algorithm>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
+namespace Vitrae
+{
+
+/**
+ * A cache of built pipelines, so switching between already used configurations doesn't build
+ * them again. Pipelines are identified by their method, desired outputs and aliases, and are
+ * shared as immutable objects. The least recently used pipelines are evicted when the cache is
+ * over capacity
+ * @note A pipeline also depends on the requirements of its tasks, so the cache has to be cleared
+ * whenever those change (i.e. when a task requests a rebuild)
+ * @note Thread safe. Pipelines are built outside the lock
+ */
+template <TaskChild BasicTask> class PipelineCache
+{
+  public:
+    static constexpr std::size_t DEFAULT_CAPACITY = 64;
+
+    PipelineCache(std::size_t capacity = DEFAULT_CAPACITY)
+        : m_capacity(capacity), m_hitCount(0), m_missCount(0)
+    {}
+
+    /**
+     * @returns The pipeline equal to Pipeline(p_method, desiredOutputSpecs, selection)
+     * @throws PipelineSetupException if the pipeline had to be built and couldn't be
+     */
+    std::shared_ptr<const Pipeline<BasicTask>> getPipeline(
+        dynasma::FirmPtr<const Method<BasicTask>> p_method, const ParamList &desiredOutputSpecs,
+        const ParamAliases &selection)
+    {
+        return getOrBuildPipeline(
+            Key{
+                .p_method = p_method,
+                .isPartial = false,
+                .parametricInputIds = {},
+                .parametrizationPolicy = PipelineParametrizationPolicy::AllDependencies,
+                .desiredOutputs = desiredOutputSpecs,
+                .selection = selection,
+            },
+            [&]() {
+                return std::make_shared<const Pipeline<BasicTask>>(p_method, desiredOutputSpecs,
+                                                                   selection);
+            });
+    }
+
+    /**
+     * @returns The partial pipeline equal to Pipeline(p_method, parametricInputIds,
+     * parametrizationPolicy, desiredOutputSpecs, selection)
+     * @throws PipelineSetupException if the pipeline had to be built and couldn't be
+     */
+    std::shared_ptr<const Pipeline<BasicTask>> getPipeline(
+        dynasma::FirmPtr<const Method<BasicTask>> p_method,
+        std::span<const StringId> parametricInputIds,
+        PipelineParametrizationPolicy parametrizationPolicy, const ParamList &desiredOutputSpecs,
+        const ParamAliases &selection)
+    {
+        // the pipeline doesn't depend on the order of parametric inputs
+        std::vector<StringId> sortedInputIds(parametricInputIds.begin(), parametricInputIds.end());
+        std::sort(sortedInputIds.begin(), sortedInputIds.end());
+
+        return getOrBuildPipeline(
+            Key{
+                .p_method = p_method,
+                .isPartial = true,
+                .parametricInputIds = std::move(sortedInputIds),
+                .parametrizationPolicy = parametrizationPolicy,
+                .desiredOutputs = desiredOutputSpecs,
+                .selection = selection,
+            },
+            [&]() {
+                return std::make_shared<const Pipeline<BasicTask>>(
+                    p_method, parametricInputIds, parametrizationPolicy, desiredOutputSpecs,
+                    selection);
+            });
+    }
+
+    /**
+     * Forgets all cached pipelines. Pipelines already returned stay valid
+     * @note The hit and miss counters are kept
+     */
+    void clear()
+    {
+        std::lock_guard lock(m_mutex);
+
+        m_entries.clear();
+        m_entriesPerHash.clear();
+    }
+
+    /**
+     * Sets the maximum number of cached pipelines, evicting the least recently used ones if needed
+     */
+    void setCapacity(std::size_t capacity)
+    {
+        std::lock_guard lock(m_mutex);
+
+        m_capacity = capacity;
+        evictOverCapacity();
+    }
+
+    std::size_t getCapacity() const
+    {
+        std::lock_guard lock(m_mutex);
+        return m_capacity;
+    }
+
+    /**
+     * @returns The number of currently cached pipelines
+     */
+    std::size_t size() const
+    {
+        std::lock_guard lock(m_mutex);
+        return m_entries.size();
+    }
+
+    /**
+     * @returns The number of requests that were served by a cached pipeline
+     */
+    std::size_t getHitCount() const
+    {
+        std::lock_guard lock(m_mutex);
+        return m_hitCount;
+    }
+
+    /**
+     * @returns The number of requests that required building the pipeline
+     */
+    std::size_t getMissCount() const
+    {
+        std::lock_guard lock(m_mutex);
+        return m_missCount;
+    }
+
+  protected:
+    struct Key
+    {
+        dynasma::FirmPtr<const Method<BasicTask>> p_method;
+        bool isPartial;
+        std::vector<StringId> parametricInputIds;
+        PipelineParametrizationPolicy parametrizationPolicy;
+
+        /**
+         * Interned when stored in the cache, so comparing it with equal interned lists is cheap
+         */
+        ParamList desiredOutputs;
+        ParamAliases selection;
+
+        std::size_t hash() const
+        {
+            std::size_t seed = combinedHashes<4>(
+                {{p_method->getHash(), desiredOutputs.getHash(), selection.hash(),
+                  isPartial ? static_cast<std::size_t>(parametrizationPolicy) + 1 : 0}});
+            for (StringId id : parametricInputIds) {
+                seed = combinedHashes<2>({{seed, std::hash<StringId>{}(id)}});
+            }
+            return seed;
+        }
+
+        bool operator==(const Key &o) const
+        {
+            // the cached key holds the method, so its address can't be reused by another one
+            return &*p_method == &*o.p_method && isPartial == o.isPartial &&
+                   parametrizationPolicy == o.parametrizationPolicy &&
+                   desiredOutputs == o.desiredOutputs &&
+                   parametricInputIds == o.parametricInputIds && selection == o.selection;
+        }
+    };
+
+    struct Entry
+    {
+        Key key;
+        std::size_t hash;
+        std::shared_ptr<const Pipeline<BasicTask>> p_pipeline;
+    };
+
+    mutable std::mutex m_mutex;
+
+    /**
+     * Cached pipelines, from the most to the least recently used
+     */
+    std::list<Entry> m_entries;
+
+    /**
+     * Entries per key hash. Keys with colliding hashes share the bucket
+     */
+    FlatHashMap<std::size_t, std::vector<typename std::list<Entry>::iterator>> m_entriesPerHash;
+
+    std::size_t m_capacity;
+    std::size_t m_hitCount;
+    std::size_t m_missCount;
+
+    template <class BuildFunc>
+    std::shared_ptr<const Pipeline<BasicTask>> getOrBuildPipeline(Key &&key, BuildFunc build)
+    {
+        std::size_t hash = key.hash();
+
+        {
+            std::lock_guard lock(m_mutex);
+
+            if (auto entryIt = findEntry(key, hash); entryIt != m_entries.end()) {
+                ++m_hitCount;
+                m_entries.splice(m_entries.begin(), m_entries, entryIt);
+                return entryIt->p_pipeline;
+            }
+            ++m_missCount;
+        }
+
+        std::shared_ptr<const Pipeline<BasicTask>> p_pipeline = build();
+
+        // the stored list is shared with equal ones, and compared by identity with them
+        key.desiredOutputs.intern();
+
+        {
+            std::lock_guard lock(m_mutex);
+
+            // the pipeline could have been built on another thread in the meantime
+            if (auto entryIt = findEntry(key, hash); entryIt != m_entries.end()) {
+                eraseEntry(entryIt);
+            }
+
+            m_entries.push_front(Entry{
+                .key = std::move(key),
+                .hash = hash,
+                .p_pipeline = p_pipeline,
+            });
+            m_entriesPerHash[hash].push_back(m_entries.begin());
+
+            evictOverCapacity();
+        }
+
+        return p_pipeline;
+    }
+
+    /**
+     * @returns The entry with the key, or m_entries.end() if there is none
+     */
+    typename std::list<Entry>::iterator findEntry(const Key &key, std::size_t hash)
+    {
+        if (auto it = m_entriesPerHash.find(hash); it != m_entriesPerHash.end()) {
+            for (auto entryIt : (*it).second) {
+                if (entryIt->key == key) {
+                    return entryIt;
+                }
+            }
+        }
+        return m_entries.end();
+    }
+
+    void eraseEntry(typename std::list<Entry>::iterator entryIt)
+    {
+        auto it = m_entriesPerHash.find(entryIt->hash);
+        auto &bucket = (*it).second;
+        bucket.erase(std::find(bucket.begin(), bucket.end(), entryIt));
+        if (bucket.empty()) {
+            m_entriesPerHash.erase(it);
+        }
+
+        m_entries.erase(entryIt);
+    }
+
+    void evictOverCapacity()
+    {
+        while (m_entries.size() > m_capacity) {
+            eraseEntry(std::prev(m_entries.end()));
+        }
+    }
+};
+
+} // namespace Vitrae
\ No newline at end of file
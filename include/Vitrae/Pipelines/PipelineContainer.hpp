@@ -26,6 +26,75 @@ template <TaskChild BasicTask> class PipelineContainer
      * Notifies that the contained pipeline should be rebuilt
      */
     virtual void rebuildContainedPipeline(const ParamAliases &aliases) const = 0;
+
+    /**
+     * @returns Whether the contained pipeline built for oldAliases would differ if built for
+     * newAliases
+     */
+    virtual bool isContainedPipelineAffected(const ParamAliases &oldAliases,
+                                             const ParamAliases &newAliases) const = 0;
+
+    /**
+     * Reuses the contained pipeline built for oldAliases as the one for newAliases, without
+     * rebuilding it
+     * @note Only valid if the pipeline isn't affected by the change
+     */
+    virtual void retargetContainedPipeline(const ParamAliases &oldAliases,
+                                           const ParamAliases &newAliases) const = 0;
 };
 
+/**
+ * @returns Whether the item of the pipeline, or a pipeline contained in it, would differ if the
+ * pipeline was built for newAliases
+ */
+template <TaskChild BasicTask>
+bool isPipelineItemAffected(const Pipeline<BasicTask> &pipeline, std::size_t itemIndex,
+                            const ParamAliases &oldAliases, const ParamAliases &newAliases)
+{
+    if (pipeline.isItemAffectedByAliasChange(itemIndex, oldAliases, newAliases)) {
+        return true;
+    }
+    if (auto p_container =
+            dynamic_cast<const PipelineContainer<BasicTask> *>(&*pipeline.items[itemIndex]);
+        p_container) {
+        return p_container->isContainedPipelineAffected(oldAliases, newAliases);
+    }
+    return false;
+}
+
+/**
+ * @returns Whether the pipeline built for oldAliases would differ if built for newAliases
+ */
+template <TaskChild BasicTask>
+bool isPipelineAffected(const Pipeline<BasicTask> &pipeline, const ParamAliases &oldAliases,
+                        const ParamAliases &newAliases)
+{
+    if (pipeline.areOutputsAffectedByAliasChange(oldAliases, newAliases)) {
+        return true;
+    }
+    for (std::size_t i = 0; i < pipeline.items.size(); ++i) {
+        if (isPipelineItemAffected(pipeline, i, oldAliases, newAliases)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Retargets the pipelines contained in the unaffected items of the pipeline to newAliases
+ * @note Affected items are left as they are, to be rebuilt
+ */
+template <TaskChild BasicTask>
+void retargetContainedPipelines(const Pipeline<BasicTask> &pipeline,
+                                const ParamAliases &oldAliases, const ParamAliases &newAliases)
+{
+    for (std::size_t i = 0; i < pipeline.items.size(); ++i) {
+        if (auto p_container =
+                dynamic_cast<const PipelineContainer<BasicTask> *>(&*pipeline.items[i]);
+            p_container && !isPipelineItemAffected(pipeline, i, oldAliases, newAliases)) {
+            p_container->retargetContainedPipeline(oldAliases, newAliases);
+        }
+    }
+}
+
 } // namespace Vitrae
\ No newline at end of file
@@ -1,39 +1,93 @@
 #pragma once
 
-#include <any>
+#include <cassert>
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <typeinfo>
+#include <utility>
 #include <vector>
 
-namespace Vitrae {
-    
-    class PipelineMemory {
-    public:
-      PipelineMemory();
-      virtual ~PipelineMemory() = default;
-
-      template <typename T, typename... Args> auto &createNext(Args &&...args)
-      {
-          return createNextAny().emplace<T>(std::forward<Args>(args)...);
-      }
-
-      template<typename T>
-      T &next() {
-          return std::any_cast<T&>(nextAny());
-      }
-
-    protected:
-        std::size_t m_nextAnyIndex;
-        std::vector<std::any> m_anyPool;
-
-        std::any &createNextAny();
-        std::any &nextAny();
-    };
+namespace Vitrae
+{
+
+/**
+ * Per-run state of pipeline items, allocated in an arena so it never moves.
+ * Items create their state while their pipeline is prepared and take it back while it runs.
+ * Pipelines are prepared in reverse and ran in order, so the state is taken in reverse order of
+ * creation
+ * @note Type mismatches are only checked in debug builds
+ */
+class PipelineMemory
+{
+  public:
+    PipelineMemory();
+    PipelineMemory(const PipelineMemory &) = delete;
+    PipelineMemory &operator=(const PipelineMemory &) = delete;
+    virtual ~PipelineMemory();
+
+    /**
+     * Constructs the state of the next item being prepared
+     * @returns The state, with its address stable until the memory is cleared
+     */
+    template <typename T, typename... Args> T &createNext(Args &&...args)
+    {
+        static_assert(alignof(T) <= alignof(std::max_align_t),
+                      "PipelineMemory doesn't support over-aligned types");
+
+        T *p_value = new (m_arena.allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        m_entries.push_back(Entry{
+            .p_value = p_value,
+            .destroy = [](void *p) { static_cast<T *>(p)->~T(); },
+            .p_type = &typeid(T),
+        });
+        m_nextEntryIndex = m_entries.size();
+
+        return *p_value;
+    }
+
+    /**
+     * @returns The state of the next item being ran
+     */
+    template <typename T> T &next()
+    {
+        assert(m_nextEntryIndex > 0 && "more states taken than created");
+        const Entry &entry = m_entries[--m_nextEntryIndex];
+        assert(*entry.p_type == typeid(T) && "state taken with a different type than created");
 
-    class RestartablePipelineMemory : public PipelineMemory {
-    public:
-      RestartablePipelineMemory();
-      ~RestartablePipelineMemory() = default;
+        return *static_cast<T *>(entry.p_value);
+    }
 
-      void restart();
-      void clear();
+  protected:
+    struct Entry
+    {
+        void *p_value;
+        void (*destroy)(void *);
+        const std::type_info *p_type;
     };
-}
\ No newline at end of file
+
+    std::pmr::monotonic_buffer_resource m_arena;
+    std::vector<Entry> m_entries;
+    std::size_t m_nextEntryIndex;
+
+    void destroyEntries();
+};
+
+class RestartablePipelineMemory : public PipelineMemory
+{
+  public:
+    RestartablePipelineMemory();
+    ~RestartablePipelineMemory() = default;
+
+    /**
+     * Prepares to take the states from the start of the run again
+     */
+    void restart();
+
+    /**
+     * Destroys all states and releases their memory, to be prepared again
+     */
+    void clear();
+};
+
+} // namespace Vitrae
\ No newline at end of file
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "Vitrae/Containers/FlatHashMap.hpp"
+#include "Vitrae/Pipelines/Pipeline.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace Vitrae
+{
+
+/**
+ * The dependencies between the items of a pipeline, derived from the specs of its tasks.
+ * An item depends on the last earlier item that wrote a property it accesses, and when it writes a
+ * property, also on the earlier items that read it since. Items without a path between them don't
+ * access the same properties, so they can run concurrently
+ * @note Outputs, filters and consumed properties are written; inputs and filters are read
+ */
+template <TaskChild BasicTask> class TaskGraph
+{
+  public:
+    struct Node
+    {
+        /**
+         * Indices of items that have to finish before this one, in ascending order
+         */
+        std::vector<std::size_t> dependencies;
+
+        /**
+         * Indices of items that wait for this one, in ascending order
+         */
+        std::vector<std::size_t> dependents;
+    };
+
+    /**
+     * Nodes for the items of the pipeline, in the same order
+     */
+    std::vector<Node> nodes;
+
+    TaskGraph() = default;
+
+    /**
+     * @param pipeline The pipeline, built for the aliases
+     * @param aliases The aliases the pipeline was built for
+     */
+    TaskGraph(const Pipeline<BasicTask> &pipeline, const ParamAliases &aliases)
+        : nodes(pipeline.items.size())
+    {
+        struct PropertyAccess
+        {
+            std::size_t lastWriter = NO_ITEM;
+            std::vector<std::size_t> readersSinceWrite;
+        };
+        FlatHashMap<StringId, PropertyAccess> accessPerProperty;
+
+        for (std::size_t index = 0; index < pipeline.items.size(); ++index) {
+            const Task &task = *pipeline.items[index];
+            std::vector<std::size_t> &dependencies = nodes[index].dependencies;
+
+            auto read = [&](StringId nameId) {
+                auto [it, inserted] =
+                    accessPerProperty.emplace(aliases.choiceFor(nameId), PropertyAccess{});
+                PropertyAccess &access = (*it).second;
+
+                if (access.lastWriter != NO_ITEM && access.lastWriter != index) {
+                    dependencies.push_back(access.lastWriter);
+                }
+                access.readersSinceWrite.push_back(index);
+            };
+
+            auto write = [&](StringId nameId) {
+                auto [it, inserted] =
+                    accessPerProperty.emplace(aliases.choiceFor(nameId), PropertyAccess{});
+                PropertyAccess &access = (*it).second;
+
+                if (access.lastWriter != NO_ITEM && access.lastWriter != index) {
+                    dependencies.push_back(access.lastWriter);
+                }
+                for (std::size_t reader : access.readersSinceWrite) {
+                    if (reader != index) {
+                        dependencies.push_back(reader);
+                    }
+                }
+                access.lastWriter = index;
+                access.readersSinceWrite.clear();
+            };
+
+            for (auto nameId : task.getInputSpecs(aliases).getSpecNameIds()) {
+                read(nameId);
+            }
+            for (auto nameId : task.getFilterSpecs(aliases).getSpecNameIds()) {
+                read(nameId);
+                write(nameId);
+            }
+            for (auto nameId : task.getConsumingSpecs(aliases).getSpecNameIds()) {
+                read(nameId);
+                write(nameId);
+            }
+            for (auto nameId : task.getOutputSpecs().getSpecNameIds()) {
+                write(nameId);
+            }
+
+            std::sort(dependencies.begin(), dependencies.end());
+            dependencies.erase(std::unique(dependencies.begin(), dependencies.end()),
+                               dependencies.end());
+
+            for (std::size_t dependency : dependencies) {
+                nodes[dependency].dependents.push_back(index);
+            }
+        }
+    }
+
+  protected:
+    static constexpr std::size_t NO_ITEM = std::numeric_limits<std::size_t>::max();
+};
+
+} // namespace Vitrae
\ No newline at end of file
@@ -18,4 +18,33 @@ inline std::size_t combinedHashes(std::span<const std::size_t, N> hashes)
     return seed;
 }
 
+/**
+ * @returns The hash with its bits thoroughly mixed (splitmix64 finalizer)
+ * @note Useful for commutative combinations of hashes, like sums for hashing unordered sets
+ */
+constexpr std::uint64_t mixedHash(std::uint64_t hash)
+{
+    hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+    return hash ^ (hash >> 31);
+}
+
+/**
+ * Hashes a sequence of values, one at a time, without storing them
+ * @note The order of the values matters
+ */
+class StreamingHash
+{
+  public:
+    constexpr void add(std::uint64_t value)
+    {
+        m_state = mixedHash(m_state ^ value) + 0x9e3779b97f4a7c15ULL;
+    }
+
+    constexpr std::uint64_t get() const { return m_state; }
+
+  private:
+    std::uint64_t m_state = 0x9e3779b97f4a7c15ULL;
+};
+
 } // namespace Vitrae
\ No newline at end of file
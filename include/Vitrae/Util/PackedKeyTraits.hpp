@@ -0,0 +1,28 @@
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+#include <type_traits>
+
+namespace Vitrae
+{
+
+/**
+ * @brief Describes whether a key type can be searched as a packed array of unsigned 64-bit
+ * integers, with the same ordering as its operator<
+ * @note Specialize for key types that wrap a single 64-bit value. toPacked() has to return that
+ * value, since vectorized searches load the keys' memory directly
+ */
+template <class KeyT> struct PackedKeyTraits
+{
+    static constexpr bool isPacked =
+        std::unsigned_integral<KeyT> && sizeof(KeyT) == sizeof(std::uint64_t);
+
+    static constexpr std::uint64_t toPacked(const KeyT &key) { return key; }
+};
+
+template <class KeyT>
+concept PackedKey = PackedKeyTraits<KeyT>::isPacked && std::is_standard_layout_v<KeyT> &&
+                    sizeof(KeyT) == sizeof(std::uint64_t);
+
+} // namespace Vitrae
\ No newline at end of file
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "Vitrae/Util/NonCopyable.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Vitrae
+{
+
+/**
+ * A pool of worker threads, each with its own queue of jobs.
+ * Workers take the newest jobs from their own queue and steal the oldest ones from the others
+ * when their queue is empty
+ * @note Jobs submitted from a worker go to its own queue, others are distributed round-robin
+ */
+class WorkStealingPool : public NonCopyable
+{
+  public:
+    using Job = std::function<void()>;
+
+    /**
+     * Starts the worker threads
+     * @param numWorkers The number of threads. Has to be at least 1
+     */
+    explicit WorkStealingPool(std::size_t numWorkers);
+
+    /**
+     * Finishes the remaining jobs and joins the worker threads
+     */
+    ~WorkStealingPool();
+
+    /**
+     * Queues the job to be ran on one of the workers
+     */
+    void submit(Job job);
+
+    std::size_t getWorkerCount() const { return m_workers.size(); }
+
+  private:
+    struct Worker
+    {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wakeCondition;
+
+    /**
+     * Number of queued jobs that weren't claimed by a worker. Guarded by m_sleepMutex
+     */
+    std::size_t m_numUnclaimedJobs;
+    bool m_stopping;
+
+    std::size_t m_nextWorkerIndex;
+
+    void workerLoop(std::size_t workerIndex);
+
+    /**
+     * Takes the newest job of the worker, or steals the oldest job of another one
+     * @returns Whether a job was found
+     */
+    bool tryTakeJob(std::size_t workerIndex, Job &outJob);
+};
+
+} // namespace Vitrae
\ No newline at end of file
@@ -2,23 +2,30 @@
 #include "Vitrae/Assets/FrameStore.hpp"
 #include "Vitrae/Collections/ComponentRoot.hpp"
 #include "Vitrae/Collections/MethodCollection.hpp"
+#include "Vitrae/Debugging/PipelineDebugSink.hpp"
 #include "Vitrae/Debugging/PipelineExport.hpp"
 #include "Vitrae/Params/Standard.hpp"
+#include "Vitrae/Pipelines/PipelineCache.hpp"
 #include "Vitrae/Pipelines/PipelineContainer.hpp"
 
 #include "MMeter.h"
 
-#include <fstream>
+#include <chrono>
 #include <ranges>
+#include <sstream>
+#include <utility>
 
 namespace Vitrae
 {
 class Renderer;
 
 Compositor::Compositor(ComponentRoot &root)
-    : m_root(root), m_needsRebuild(true), m_needsFrameStoreRegeneration(true), m_pipeline(),
-      m_localProperties(&parameters)
-{}
+    : m_root(root), m_needsRebuild(true), m_needsFrameStoreRegeneration(true),
+      mp_pipeline(std::make_shared<const Pipeline<ComposeTask>>()), m_localProperties(&parameters),
+      m_asyncRebuild(false)
+{
+    m_localProperties.bindSlots(&mp_pipeline->slots);
+}
 std::size_t Compositor::memory_cost() const
 {
     /// TODO: implement
@@ -29,7 +36,25 @@ void Compositor::setParamAliases(const ParamAliases &aliases)
 {
     m_aliases = aliases;
 
-    m_needsRebuild = true;
+    updatePipelineForAliases();
+}
+
+void Compositor::updatePipelineForAliases()
+{
+    // a pipeline being solved is checked against the aliases once it is done
+    if (m_needsRebuild || m_pendingPipeline.valid()) {
+        return;
+    }
+
+    // keep the pipeline and its memory if none of its tasks depend on the changed aliases
+    if (!isPipelineAffected(*mp_pipeline, m_pipelineAliases, m_aliases)) {
+        retargetContainedPipelines(*mp_pipeline, m_pipelineAliases, m_aliases);
+        m_pipelineAliases = m_aliases;
+    } else if (m_asyncRebuild) {
+        startSolvingPipeline();
+    } else {
+        m_needsRebuild = true;
+    }
 }
 
 void Compositor::setDesiredProperties(const ParamList &properties)
@@ -39,9 +64,23 @@ void Compositor::setDesiredProperties(const ParamList &properties)
     m_needsRebuild = true;
 }
 
+void Compositor::setWorkerCount(std::size_t numWorkers)
+{
+    if (numWorkers > 0) {
+        mp_executor = std::make_unique<ComposeExecutor>(numWorkers);
+    } else {
+        mp_executor.reset();
+    }
+}
+
+void Compositor::setAsyncRebuild(bool enabled)
+{
+    m_asyncRebuild = enabled;
+}
+
 const ParamList &Compositor::getInputSpecs() const
 {
-    return m_pipeline.inputSpecs;
+    return m_inputSpecs;
 }
 
 void Compositor::compose()
@@ -50,15 +89,6 @@ void Compositor::compose()
 
     // VariantScope localVars(&parameters);
 
-    // setup the rendering context
-    ArgumentScope scope(&m_localProperties, &m_aliases);
-    RenderComposeContext context{
-        .properties = scope,
-        .root = m_root,
-        .aliases = m_aliases,
-        .pipelineMemory = m_pipelineMemory,
-    };
-
     bool tryExecute = true;
 
     while (tryExecute) {
@@ -66,6 +96,9 @@ void Compositor::compose()
 
         tryExecute = false;
 
+        // swap in the pipeline solved in the background, between runs
+        adoptSolvedPipeline();
+
         // rebuild the pipeline if needed
         while (m_needsRebuild || m_needsFrameStoreRegeneration) {
             if (m_needsRebuild) {
@@ -76,19 +109,40 @@ void Compositor::compose()
             }
         }
 
+        // setup the rendering context (after the rebuild, since the slots could have changed)
+        // the pipeline could still be built for the previous aliases while the next one is solved
+        ArgumentScope scope(&m_localProperties, &m_pipelineAliases, &mp_pipeline->slots);
+        RenderComposeContext context{
+            .properties = scope,
+            .root = m_root,
+            .aliases = m_pipelineAliases,
+            .pipelineMemory = m_pipelineMemory,
+            .requests = m_requests,
+        };
+
+        m_requests.clear();
+
         try {
             // execute the pipeline
             m_pipelineMemory.restart();
             {
                 MMETER_SCOPE_PROFILER("Pipeline execution");
 
-                for (auto p_task : m_pipeline.items) {
-                    p_task->run(context);
+                if (mp_executor) {
+                    mp_executor->run(*mp_pipeline, m_taskGraph, context);
+                } else {
+                    for (auto p_task : mp_pipeline->items) {
+                        p_task->run(context);
+
+                        if (m_requests.hasRequests()) {
+                            break;
+                        }
+                    }
                 }
             }
 
             // sync the final framebuffer
-            {
+            if (!m_requests.hasRequests()) {
                 MMETER_SCOPE_PROFILER("FrameStore sync");
 
                 parameters.get(StandardParam::fs_display.name)
@@ -97,7 +151,15 @@ void Compositor::compose()
             }
         }
         catch (ComposeTaskRequirementsChangedException) {
-            m_needsRebuild = true;
+            m_requests.requestRebuild();
+        }
+
+        // all requests of the run are handled with one rebuild
+        if (m_requests.isRebuildRequested()) {
+            invalidatePipelines();
+            tryExecute = true;
+        } else if (m_requests.isPreparationRequested()) {
+            m_needsFrameStoreRegeneration = true;
             tryExecute = true;
         }
     }
@@ -115,46 +177,67 @@ void Compositor::rebuildPipeline()
 
     m_needsRebuild = false;
 
+    // the tasks can't be modified while a pipeline is being solved
+    discardSolvedPipeline();
+
     // erase previous pipeline
-    for (auto p_task : m_pipeline.items) {
-        if (const PipelineContainer<ComposeTask> *p_container =
-                dynamic_cast<const PipelineContainer<ComposeTask> *>(&*p_task);
-            p_container) {
-            p_container->rebuildContainedPipeline(m_aliases);
+    if (m_pipelineAliases == m_aliases) {
+        for (auto p_task : mp_pipeline->items) {
+            if (const PipelineContainer<ComposeTask> *p_container =
+                    dynamic_cast<const PipelineContainer<ComposeTask> *>(&*p_task);
+                p_container) {
+                p_container->rebuildContainedPipeline(m_aliases);
+            }
         }
+    } else {
+        // only the tasks affected by the alias change need to be rebuilt
+        retargetContainedPipelines(*mp_pipeline, m_pipelineAliases, m_aliases);
     }
 
-    // setup the rendering context
-    ArgumentScope scope(&m_localProperties, &m_aliases);
-    RenderComposeContext context{
-        .properties = scope,
-        .root = m_root,
-        .aliases = m_aliases,
-        .pipelineMemory = m_pipelineMemory,
-    };
+    auto p_pipeline = m_root.getComponent<PipelineCache<ComposeTask>>().getPipeline(
+        m_root.getComponent<MethodCollection>().getComposeMethod(), m_desiredProperties, m_aliases);
+    TaskGraph<ComposeTask> taskGraph(*p_pipeline, m_aliases);
 
-    m_pipeline = Pipeline<ComposeTask>(m_root.getComponent<MethodCollection>().getComposeMethod(),
-                                       m_desiredProperties, m_aliases);
+    setPipeline(std::move(p_pipeline), std::move(taskGraph));
+}
 
-    String filePrefix =
-        std::string("shaderdebug/") + "compositor_" + getPipelineId(m_pipeline, m_aliases);
-    {
-        std::ofstream file;
-        String filename = filePrefix + ".dot";
-        file.open(filename);
-        exportPipeline(m_pipeline, m_aliases, file);
-        file.close();
+void Compositor::setPipeline(std::shared_ptr<const Pipeline<ComposeTask>> p_pipeline,
+                             TaskGraph<ComposeTask> taskGraph)
+{
+    // the local properties keep their values by name while the slots are being replaced
+    m_localProperties.bindSlots(nullptr);
+    mp_pipeline = std::move(p_pipeline);
+    m_localProperties.bindSlots(&mp_pipeline->slots);
+    m_pipelineAliases = m_aliases;
+    m_taskGraph = std::move(taskGraph);
+
+    if (PipelineDebugSink &debugSink = m_root.getComponent<PipelineDebugSink>();
+        debugSink.isEnabled()) {
+        String filePrefix = "compositor_" + toHexString(mp_pipeline->fingerprint, 16);
+        {
+            std::stringstream graph;
+            exportPipeline(*mp_pipeline, m_aliases, graph);
+            debugSink.write(filePrefix + ".dot", graph.str());
 
-        m_root.getInfoStream() << "Compositor graph stored to: '"
-                               << (std::filesystem::current_path() / filename) << "'" << std::endl;
+            m_root.getInfoStream()
+                << "Compositor graph stored to: '"
+                << (std::filesystem::current_path() / debugSink.getFilePath(filePrefix + ".dot"))
+                << "'" << std::endl;
+        }
+        {
+            std::stringstream graph;
+            exportTaskGraph(*mp_pipeline, m_taskGraph, graph);
+            debugSink.write(filePrefix + "_tasks.dot", graph.str());
+        }
     }
 
     // add compositor properties, so they are visible from the outside
-    m_pipeline.inputSpecs.insert_back(StandardParam::vsync);
+    m_inputSpecs = mp_pipeline->inputSpecs;
+    m_inputSpecs.insert_back(StandardParam::vsync);
 
     // Set default values
-    for (auto p_specs :
-         {&m_pipeline.inputSpecs, &m_pipeline.filterSpecs, &m_pipeline.consumingSpecs}) {
+    for (auto p_specs : {&std::as_const(m_inputSpecs), &mp_pipeline->filterSpecs,
+                         &mp_pipeline->consumingSpecs}) {
         for (auto &spec : p_specs->getSpecList()) {
             if (spec.defaultValue.getAssignedTypeInfo() != TYPE_INFO<void> &&
                 !parameters.has(spec.name)) {
@@ -166,6 +249,66 @@ void Compositor::rebuildPipeline()
     m_needsFrameStoreRegeneration = true;
 }
 
+void Compositor::startSolvingPipeline()
+{
+    // the solving thread only gets copies, and the thread safe pipeline cache
+    m_pendingPipeline = std::async(
+        std::launch::async,
+        [&pipelineCache = m_root.getComponent<PipelineCache<ComposeTask>>(),
+         p_method = m_root.getComponent<MethodCollection>().getComposeMethod(),
+         desiredProperties = m_desiredProperties, aliases = m_aliases]() {
+            MMETER_SCOPE_PROFILER("Compositor background solving");
+
+            auto p_pipeline = pipelineCache.getPipeline(p_method, desiredProperties, aliases);
+            TaskGraph<ComposeTask> taskGraph(*p_pipeline, aliases);
+
+            return SolvedPipeline{
+                .aliases = aliases,
+                .p_pipeline = std::move(p_pipeline),
+                .taskGraph = std::move(taskGraph),
+            };
+        });
+}
+
+void Compositor::adoptSolvedPipeline()
+{
+    if (!m_pendingPipeline.valid() ||
+        m_pendingPipeline.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return;
+    }
+
+    SolvedPipeline solved = m_pendingPipeline.get();
+
+    if (m_needsRebuild) {
+        return;
+    }
+
+    if (solved.aliases == m_aliases) {
+        setPipeline(std::move(solved.p_pipeline), std::move(solved.taskGraph));
+    } else {
+        // the aliases changed again while solving
+        updatePipelineForAliases();
+    }
+}
+
+void Compositor::discardSolvedPipeline()
+{
+    if (m_pendingPipeline.valid()) {
+        m_pendingPipeline.wait();
+        m_pendingPipeline = {};
+    }
+}
+
+void Compositor::invalidatePipelines()
+{
+    // otherwise the pipeline being solved could be cached after clearing
+    discardSolvedPipeline();
+
+    // cached pipelines were built for the old requirements
+    m_root.getComponent<PipelineCache<ComposeTask>>().clear();
+    m_needsRebuild = true;
+}
+
 void Compositor::regenerateFrameStores()
 {
     MMETER_SCOPE_PROFILER("Compositor::regenerateFrameStores");
@@ -175,36 +318,50 @@ void Compositor::regenerateFrameStores()
     m_pipelineMemory.clear();
 
     // setup the rendering context
-    ArgumentScope scope(&m_localProperties, &m_aliases);
+    ArgumentScope scope(&m_localProperties, &m_pipelineAliases, &mp_pipeline->slots);
     RenderComposeContext context{
         .properties = scope,
         .root = m_root,
-        .aliases = m_aliases,
+        .aliases = m_pipelineAliases,
         .pipelineMemory = m_pipelineMemory,
+        .requests = m_requests,
     };
 
+    m_requests.clear();
+
     // process
     try {
-        for (auto p_task : std::ranges::reverse_view{m_pipeline.items}) {
+        for (auto p_task : std::ranges::reverse_view{mp_pipeline->items}) {
             p_task->prepareRequiredLocalAssets(context);
-        }
 
-        String filePrefix =
-            std::string("shaderdebug/") + "full_" + getPipelineId(m_pipeline, m_aliases);
-        {
-            std::ofstream file;
-            String filename = filePrefix + ".dot";
-            file.open(filename);
-            exportPipeline(m_pipeline, m_aliases, file, "", true, true);
-            file.close();
-
-            m_root.getInfoStream()
-                << "Compositor graph stored to: '" << (std::filesystem::current_path() / filename)
-                << "'" << std::endl;
+            if (m_requests.hasRequests()) {
+                break;
+            }
         }
     }
     catch (ComposeTaskRequirementsChangedException) {
-        m_needsRebuild = true;
+        m_requests.requestRebuild();
+    }
+
+    if (m_requests.isRebuildRequested()) {
+        invalidatePipelines();
+        return;
+    } else if (m_requests.isPreparationRequested()) {
+        m_needsFrameStoreRegeneration = true;
+        return;
+    }
+
+    if (PipelineDebugSink &debugSink = m_root.getComponent<PipelineDebugSink>();
+        debugSink.isEnabled()) {
+        String filename = "full_" + toHexString(mp_pipeline->fingerprint, 16) + ".dot";
+        std::stringstream graph;
+        exportPipeline(*mp_pipeline, m_pipelineAliases, graph, "", true, true);
+        debugSink.write(filename, graph.str());
+
+        m_root.getInfoStream()
+            << "Compositor graph stored to: '"
+            << (std::filesystem::current_path() / debugSink.getFilePath(filename)) << "'"
+            << std::endl;
     }
 }
 
@@ -14,6 +14,11 @@ Material::Material(const AssimpLoadParams &params) : m_root(params.root)
 
     std::filesystem::path parentDirPath = params.sceneFilepath.parent_path();
 
+    // avoid reallocating the maps for each added property
+    m_tobeInternalAliases.reserve(params.root.getAiMaterialTextureInfos().size() * 2);
+    m_properties.reserve(params.root.getAiMaterialTextureInfos().size() +
+                         params.root.getAiMaterialPropertyInfos().size());
+
     // Get all textures
     for (auto &textureInfo : params.root.getAiMaterialTextureInfos()) {
         if (params.p_extMaterial->GetTextureCount(textureInfo.aiTextureId) > 0) {
@@ -25,16 +30,16 @@ Material::Material(const AssimpLoadParams &params) : m_root(params.root)
                     searchAndReplace(searchAndReplace(path.C_Str(), "\\", "/"), "//", "/");
 
                 // add alias for texture coordinate
-                m_tobeInternalAliases["coord_" + textureInfo.colorName] =
+                m_tobeInternalAliases[StringId::concat("coord_", textureInfo.colorName)] =
                     StandardParam::coord_base.name;
 
                 // add alias for texture color
-                m_tobeInternalAliases["color_" + textureInfo.colorName] =
+                m_tobeInternalAliases[StringId::concat("color_", textureInfo.colorName)] =
                     "sample_" + textureInfo.colorName;
 
                 // set texture
                 m_root.getComponent<Renderer>().specifyTextureSampler(textureInfo.colorName);
-                m_properties["tex_" + textureInfo.colorName] =
+                m_properties[StringId::concat("tex_", textureInfo.colorName)] =
                     textureManager
                         .register_asset(
                             {Texture::FileLoadParams{.root = params.root,
@@ -45,10 +50,12 @@ Material::Material(const AssimpLoadParams &params) : m_root(params.root)
                                                          }}})
                         .getLoaded();
             } else {
-                m_properties["color_" + textureInfo.colorName] = textureInfo.defaultColor;
+                m_properties[StringId::concat("color_", textureInfo.colorName)] =
+                    textureInfo.defaultColor;
             }
         } else {
-            m_properties["color_" + textureInfo.colorName] = textureInfo.defaultColor;
+            m_properties[StringId::concat("color_", textureInfo.colorName)] =
+                textureInfo.defaultColor;
         }
     }
 
@@ -98,30 +105,31 @@ void Material::setTexture(StringView colorName, dynasma::FirmPtr<Texture> textur
                           StringView coordPropertyName)
 {
     // add alias for texture coordinate
-    m_tobeInternalAliases["coord_" + std::string(colorName)] = std::string(coordPropertyName);
+    m_tobeInternalAliases[StringId::concat("coord_", colorName)] = std::string(coordPropertyName);
 
     // add alias for texture color
-    m_tobeInternalAliases["color_" + std::string(colorName)] = "sample_" + std::string(colorName);
+    m_tobeInternalAliases[StringId::concat("color_", colorName)] =
+        "sample_" + std::string(colorName);
 
     m_aliases = ParamAliases({{&m_externalAliases}}, m_tobeInternalAliases);
 
     // set texture
     m_root.getComponent<Renderer>().specifyTextureSampler(colorName);
-    m_properties["tex_" + std::string(colorName)] = std::move(texture);
+    m_properties[StringId::concat("tex_", colorName)] = std::move(texture);
 }
 
 void Material::setTexture(StringView colorName, glm::vec4 uniformColor)
 {
     // erase alias for texture coordinate
-    m_tobeInternalAliases.erase("coord_" + std::string(colorName));
+    m_tobeInternalAliases.erase(StringId::concat("coord_", colorName));
 
     // erase alias for texture sample
-    m_tobeInternalAliases.erase("color_" + std::string(colorName));
+    m_tobeInternalAliases.erase(StringId::concat("color_", colorName));
 
     m_aliases = ParamAliases({{&m_externalAliases}}, m_tobeInternalAliases);
 
     // set color of all samples
-    m_properties["color_" + std::string(colorName)] = uniformColor;
+    m_properties[StringId::concat("color_", colorName)] = uniformColor;
 }
 const ParamAliases &Material::getParamAliases() const
 {
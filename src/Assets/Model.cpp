@@ -13,32 +13,29 @@
 namespace Vitrae
 {
 Model::Model(const AssimpLoadParams &params) : m_root(params.root)
+{
+    loadVisualFormFromAssimp(params);
+}
+
+Model::Model(const FormParams &params)
+    : m_root(params.root), m_formsByPurpose(params.formsByPurpose), mp_material(params.p_material),
+      m_boundingBox(params.boundingBox)
+{}
+
+Model::~Model() {}
+
+void Model::loadVisualFormFromAssimp(const AssimpLoadParams &params)
 {
     MeshKeeper &meshKeeper = params.root.getComponent<MeshKeeper>();
     auto p_mesh =
         meshKeeper.new_asset({Mesh::AssimpLoadParams{params.root, params.p_extMesh}}).getLoaded();
 
-    // Calculate minimum edge length
-    float minEdgeLength = std::numeric_limits<float>::max();
-
-    std::span<const Triangle> triangles = p_mesh->getTriangles();
-    StridedSpan<const glm::vec3> positions =
-        p_mesh->getVertexComponentData<glm::vec3>(StandardParam::position.name);
-    for (const auto &tri : triangles) {
-        unsigned int i0 = tri.ind[0];
-        unsigned int i1 = tri.ind[1];
-        unsigned int i2 = tri.ind[2];
-        if (i0 < positions.size() && i1 < positions.size() && i2 < positions.size()) {
-            float e0 = glm::distance(positions[i0], positions[i1]);
-            float e1 = glm::distance(positions[i1], positions[i2]);
-            float e2 = glm::distance(positions[i2], positions[i0]);
-
-            minEdgeLength = std::min(minEdgeLength, std::min(e0, std::min(e1, e2)));
-        } else {
-            throw std::runtime_error{"Invalid triangle index for model"};
-        }
-    }
+    float minEdgeLength = params.minEdgeLength.has_value()
+                              ? params.minEdgeLength.value()
+                              : computeMinEdgeLength(*params.p_extMesh);
 
+    // forms generated for other purposes were based on the previous forms
+    m_formsByPurpose.clear();
     addForm("visual",
             std::shared_ptr<Vitrae::LoDMeasure>(new SmallestElementSizeMeasure(minEdgeLength)),
             p_mesh);
@@ -47,11 +44,40 @@ Model::Model(const AssimpLoadParams &params) : m_root(params.root)
     m_boundingBox = p_mesh->getBoundingBox();
 }
 
-Model::Model(const FormParams &params)
-    : m_root(params.root), m_formsByPurpose(params.formsByPurpose), mp_material(params.p_material)
-{}
+float Model::computeMinEdgeLength(const aiMesh &extMesh)
+{
+    float minEdgeLength = std::numeric_limits<float>::max();
 
-Model::~Model() {}
+    auto position = [&](unsigned int index) {
+        const aiVector3D &v = extMesh.mVertices[index];
+        return glm::vec3(v.x, v.y, v.z);
+    };
+
+    for (unsigned int faceIndex = 0; faceIndex < extMesh.mNumFaces; ++faceIndex) {
+        const aiFace &face = extMesh.mFaces[faceIndex];
+
+        // only triangles are part of the mesh
+        if (face.mNumIndices != 3) {
+            continue;
+        }
+
+        unsigned int i0 = face.mIndices[0];
+        unsigned int i1 = face.mIndices[1];
+        unsigned int i2 = face.mIndices[2];
+        if (i0 < extMesh.mNumVertices && i1 < extMesh.mNumVertices &&
+            i2 < extMesh.mNumVertices) {
+            float e0 = glm::distance(position(i0), position(i1));
+            float e1 = glm::distance(position(i1), position(i2));
+            float e2 = glm::distance(position(i2), position(i0));
+
+            minEdgeLength = std::min(minEdgeLength, std::min(e0, std::min(e1, e2)));
+        } else {
+            throw std::runtime_error{"Invalid triangle index for model"};
+        }
+    }
+
+    return minEdgeLength;
+}
 
 void Model::setMaterial(dynasma::LazyPtr<Material> p_mat)
 {
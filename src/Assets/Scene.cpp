@@ -2,14 +2,194 @@
 
 #include "Vitrae/Assets/Material.hpp"
 #include "Vitrae/Assets/Model.hpp"
+#include "Vitrae/Assets/SceneCache.hpp"
 #include "Vitrae/Collections/ComponentRoot.hpp"
+#include "Vitrae/Util/WorkStealingPool.hpp"
 
 #include "assimp/Importer.hpp"
 #include "assimp/postprocess.h"
 #include "assimp/scene.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <future>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <optional>
+
 namespace Vitrae
 {
+
+namespace
+{
+/**
+ * Flags of the assimp import. Part of the scene cache key, so changing them invalidates caches
+ */
+constexpr unsigned int IMPORT_FLAGS = aiProcess_CalcTangentSpace | aiProcess_Triangulate |
+                                      aiProcess_JoinIdenticalVertices | aiProcess_SortByPType |
+                                      aiProcess_FlipUVs | aiProcess_GenBoundingBoxes;
+
+/**
+ * Results of scanning the meshes on worker threads, waited for in order of the meshes
+ */
+struct MeshScanState
+{
+    std::vector<float> minEdgeLengths;
+    std::vector<std::exception_ptr> exceptions;
+
+    // guards the scanned flags
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::vector<bool> scanned;
+
+    MeshScanState(std::size_t numMeshes)
+        : minEdgeLengths(numMeshes), exceptions(numMeshes), scanned(numMeshes, false)
+    {}
+
+    void scan(std::size_t index, const aiMesh &extMesh)
+    {
+        try {
+            minEdgeLengths[index] = Model::computeMinEdgeLength(extMesh);
+        }
+        catch (...) {
+            exceptions[index] = std::current_exception();
+        }
+
+        std::lock_guard lock(mutex);
+        scanned[index] = true;
+        condition.notify_all();
+    }
+
+    float waitForResult(std::size_t index)
+    {
+        {
+            std::unique_lock lock(mutex);
+            condition.wait(lock, [&]() { return scanned[index]; });
+        }
+
+        if (exceptions[index]) {
+            std::rethrow_exception(exceptions[index]);
+        }
+        return minEdgeLengths[index];
+    }
+};
+
+/**
+ * A scene imported from the file or read from its cache
+ */
+struct ImportedScene
+{
+    std::unique_ptr<Assimp::Importer> p_importer;
+    std::unique_ptr<CachedScene> p_cachedScene;
+
+    /**
+     * The scene owned by one of the above, or nullptr if it couldn't be imported
+     */
+    const aiScene *p_extScene = nullptr;
+
+    std::optional<std::uint64_t> cacheKey;
+    std::vector<float> meshMinEdgeLengths;
+
+    /**
+     * Errors to print once the scene is used
+     */
+    String errors;
+};
+
+ImportedScene importScene(const std::filesystem::path &filepath,
+                          const std::filesystem::path &cacheFilepath)
+{
+    ImportedScene imported;
+
+    if (!cacheFilepath.empty()) {
+        // the cache is only an optimization, so the scene is imported if it can't be used
+        try {
+            imported.cacheKey = computeSceneCacheKey(filepath, IMPORT_FLAGS);
+            imported.p_cachedScene = readSceneCache(cacheFilepath, imported.cacheKey.value(),
+                                                    imported.meshMinEdgeLengths);
+            if (imported.p_cachedScene) {
+                imported.p_extScene = &imported.p_cachedScene->getScene();
+            }
+        }
+        catch (const std::exception &e) {
+            imported.errors += String("Scene cache not loaded: ") + e.what() + "\n";
+        }
+    }
+
+    if (!imported.p_extScene) {
+        imported.meshMinEdgeLengths.clear();
+        imported.p_importer = std::make_unique<Assimp::Importer>();
+        imported.p_extScene = imported.p_importer->ReadFile(filepath.c_str(), IMPORT_FLAGS);
+
+        if (!imported.p_extScene) {
+            imported.errors += imported.p_importer->GetErrorString();
+        }
+    }
+
+    return imported;
+}
+
+/**
+ * Writes the scene to the cache, if it was imported from the source file
+ */
+void saveSceneCache(ImportedScene &imported, const std::filesystem::path &cacheFilepath)
+{
+    if (imported.p_importer && imported.p_extScene && imported.cacheKey.has_value()) {
+        try {
+            writeSceneCache(cacheFilepath, imported.cacheKey.value(), *imported.p_extScene,
+                            imported.meshMinEdgeLengths);
+        }
+        catch (const std::exception &e) {
+            imported.errors += String("Scene cache not saved: ") + e.what() + "\n";
+        }
+    }
+}
+} // namespace
+
+struct Scene::StreamingState
+{
+    ComponentRoot &root;
+    std::filesystem::path sceneFilepath;
+    StreamingParams params;
+
+    /**
+     * The scene being imported in the background, until continueStreaming() adopts it.
+     * Destroying the scene while importing waits for the import to finish
+     */
+    std::future<ImportedScene> pendingImport;
+    ImportedScene imported;
+
+    std::vector<dynasma::FirmPtr<Model>> modelById;
+    std::vector<dynasma::LazyPtr<Material>> matById;
+
+    /**
+     * The transformation indices of the props using each mesh's model
+     */
+    std::vector<std::vector<std::size_t>> transformIndicesByMesh;
+
+    /**
+     * The meshes whose models still have placeholder forms. The last numSelectedMeshes of them
+     * are the closest, ordered so the closest is at the back
+     */
+    std::vector<std::uint32_t> pendingMeshes;
+    std::size_t numSelectedMeshes = 0;
+
+    /**
+     * The distance from the camera to the closest prop using each mesh, as of the last update
+     */
+    std::vector<float> meshDistances;
+    std::optional<glm::vec3> priorityCameraPosition;
+    std::size_t callsSincePriorityUpdate = 0;
+
+    /**
+     * Used to estimate how many meshes load within the time budget
+     */
+    std::chrono::steady_clock::duration totalLoadTime = {};
+    std::size_t numLoadedMeshes = 0;
+};
+
 Scene::Scene(const AssimpLoadParams &params)
 {
     loadFromAssimp(params);
@@ -17,32 +197,169 @@ Scene::Scene(const AssimpLoadParams &params)
 
 Scene::Scene(const FileLoadParams &params)
 {
-    Assimp::Importer importer;
+    if (params.streaming.has_value()) {
+        // the meshes are scanned and the cache written in the background too
+        mp_streamingState.reset(new StreamingState{
+            .root = params.root,
+            .sceneFilepath = params.filepath,
+            .params = params.streaming.value(),
+            .pendingImport = std::async(
+                std::launch::async,
+                [filepath = params.filepath, cacheFilepath = params.cacheFilepath,
+                 numWorkers = params.numWorkers]() {
+                    ImportedScene imported = importScene(filepath, cacheFilepath);
+                    if (!imported.p_extScene) {
+                        return imported;
+                    }
+
+                    const aiScene &extScene = *imported.p_extScene;
+                    std::size_t numMeshes = extScene.HasMeshes() ? extScene.mNumMeshes : 0;
+
+                    if (imported.meshMinEdgeLengths.size() != numMeshes) {
+                        MeshScanState scanState(numMeshes);
+                        std::optional<WorkStealingPool> workerPool;
+                        if (numWorkers > 0) {
+                            workerPool.emplace(numWorkers);
+                            for (std::size_t i = 0; i < numMeshes; ++i) {
+                                workerPool->submit([&scanState, &extScene, i]() {
+                                    scanState.scan(i, *extScene.mMeshes[i]);
+                                });
+                            }
+                        }
 
-    const aiScene *scene = importer.ReadFile(
-        params.filepath.c_str(), aiProcess_CalcTangentSpace | aiProcess_Triangulate |
-                                     aiProcess_JoinIdenticalVertices | aiProcess_SortByPType |
-                                     aiProcess_FlipUVs | aiProcess_GenBoundingBoxes);
+                        imported.meshMinEdgeLengths.resize(numMeshes);
+                        for (std::size_t i = 0; i < numMeshes; ++i) {
+                            if (!workerPool.has_value()) {
+                                scanState.scan(i, *extScene.mMeshes[i]);
+                            }
+                            imported.meshMinEdgeLengths[i] = scanState.waitForResult(i);
+                        }
+                    }
 
-    if (!scene) {
-        params.root.getErrStream() << importer.GetErrorString();
+                    saveSceneCache(imported, cacheFilepath);
+                    return imported;
+                }),
+        });
         return;
     }
 
-    loadFromAssimp({.root = params.root, .p_extScene = scene, .sceneFilepath = params.filepath});
+    ImportedScene imported = importScene(params.filepath, params.cacheFilepath);
+
+    if (imported.p_extScene) {
+        imported.meshMinEdgeLengths = loadFromAssimp({
+            .root = params.root,
+            .p_extScene = imported.p_extScene,
+            .sceneFilepath = params.filepath,
+            .numWorkers = params.numWorkers,
+            .meshMinEdgeLengths = imported.meshMinEdgeLengths,
+        });
+
+        saveSceneCache(imported, params.cacheFilepath);
+    }
 
-    importer.FreeScene();
+    params.root.getErrStream() << imported.errors;
 }
 
+Scene::~Scene() {}
+
 std::size_t Scene::memory_cost() const
 {
     return sizeof(Scene);
 }
 
-void Scene::loadFromAssimp(const AssimpLoadParams &params)
+ModelProp &Scene::addModelProp(dynasma::FirmPtr<Model> p_model,
+                               const SimpleTransformation &transform)
+{
+    return modelProps.emplace_back(ModelProp{
+        .p_model = std::move(p_model),
+        .transformIndex = propTransforms.add(transform),
+    });
+}
+
+BoundingBox Scene::getPropWorldBoundingBox(const ModelProp &prop) const
+{
+    return transformed(getPropModelMatrix(prop), prop.p_model->getBoundingBox());
+}
+
+void Scene::rebuildPropHierarchy()
+{
+    propTransforms.updateMatrices();
+
+    std::vector<BoundingBox> worldBoxes;
+    worldBoxes.reserve(modelProps.size());
+    m_propIndexPerTransform.assign(propTransforms.count(), NO_PROP);
+    for (std::size_t index = 0; index < modelProps.size(); ++index) {
+        const ModelProp &prop = modelProps[index];
+        worldBoxes.push_back(getPropWorldBoundingBox(prop));
+        m_propIndexPerTransform[prop.transformIndex] = static_cast<std::uint32_t>(index);
+    }
+
+    m_propHierarchy.build(worldBoxes);
+}
+
+void Scene::updatePropHierarchy()
+{
+    if (!propTransforms.hasChanges()) {
+        return;
+    }
+
+    // the changes are only known until the matrices are updated
+    std::vector<std::uint32_t> movedProps;
+    for (std::uint32_t transformIndex : propTransforms.getChangedIndices()) {
+        // props added or removed since the last rebuild are skipped
+        if (transformIndex < m_propIndexPerTransform.size() &&
+            m_propIndexPerTransform[transformIndex] < modelProps.size()) {
+            movedProps.push_back(m_propIndexPerTransform[transformIndex]);
+        }
+    }
+
+    propTransforms.updateMatrices();
+
+    std::vector<BoundingBox> movedBoxes;
+    movedBoxes.reserve(movedProps.size());
+    for (std::uint32_t index : movedProps) {
+        movedBoxes.push_back(getPropWorldBoundingBox(modelProps[index]));
+    }
+
+    m_propHierarchy.refit(movedProps, movedBoxes);
+}
+
+void Scene::collectPropsInFrustum(const Frustum &frustum,
+                                  std::vector<const ModelProp *> &outProps) const
+{
+    m_propHierarchy.forEachIntersecting(frustum, [&](std::size_t index) {
+        // props removed since the last rebuild are skipped
+        if (index < modelProps.size()) {
+            outProps.push_back(&modelProps[index]);
+        }
+    });
+
+    for (std::size_t index = m_propHierarchy.count(); index < modelProps.size(); ++index) {
+        outProps.push_back(&modelProps[index]);
+    }
+}
+
+std::vector<float> Scene::loadFromAssimp(const AssimpLoadParams &params)
 {
     MaterialKeeper &matKeeper = params.root.getComponent<MaterialKeeper>();
 
+    std::size_t numMeshes = params.p_extScene->HasMeshes() ? params.p_extScene->mNumMeshes : 0;
+    std::vector<float> meshMinEdgeLengths(params.meshMinEdgeLengths.begin(),
+                                          params.meshMinEdgeLengths.end());
+    bool scanMeshes = meshMinEdgeLengths.size() != numMeshes;
+    meshMinEdgeLengths.resize(numMeshes);
+
+    // scan the meshes on the workers while the assets are created here
+    MeshScanState scanState(numMeshes);
+    std::optional<WorkStealingPool> workerPool;
+    if (scanMeshes && params.numWorkers > 0) {
+        workerPool.emplace(params.numWorkers);
+        for (std::size_t i = 0; i < numMeshes; ++i) {
+            workerPool->submit(
+                [&scanState, &params, i]() { scanState.scan(i, *params.p_extScene->mMeshes[i]); });
+        }
+    }
+
     // load materials
     std::vector<dynasma::LazyPtr<Material>> matById;
     if (params.p_extScene->HasMaterials()) {
@@ -60,8 +377,19 @@ void Scene::loadFromAssimp(const AssimpLoadParams &params)
     std::vector<dynasma::FirmPtr<Model>> modelById;
     if (params.p_extScene->HasMeshes()) {
         for (unsigned int i = 0; i < params.p_extScene->mNumMeshes; ++i) {
-            dynasma::FirmPtr<Model> p_model = dynasma::makeStandalone<Model>(
-                Model::AssimpLoadParams{params.root, params.p_extScene->mMeshes[i]});
+            if (scanMeshes) {
+                meshMinEdgeLengths[i] =
+                    workerPool.has_value()
+                        ? scanState.waitForResult(i)
+                        : Model::computeMinEdgeLength(*params.p_extScene->mMeshes[i]);
+            }
+
+            dynasma::FirmPtr<Model> p_model =
+                dynasma::makeStandalone<Model>(Model::AssimpLoadParams{
+                    .root = params.root,
+                    .p_extMesh = params.p_extScene->mMeshes[i],
+                    .minEdgeLength = meshMinEdgeLengths[i],
+                });
 
             // set material
             p_model->setMaterial(matById[params.p_extScene->mMeshes[i]->mMaterialIndex]);
@@ -70,6 +398,18 @@ void Scene::loadFromAssimp(const AssimpLoadParams &params)
         }
     }
 
+    addPropsFromAssimp(*params.p_extScene, modelById);
+    rebuildPropHierarchy();
+    loadCameraFromAssimp(*params.p_extScene);
+
+    return meshMinEdgeLengths;
+}
+
+std::vector<std::uint32_t> Scene::addPropsFromAssimp(
+    const aiScene &extScene, std::span<const dynasma::FirmPtr<Model>> modelById)
+{
+    std::vector<std::uint32_t> propMeshIndices;
+
     std::function<void(const aiNode *, const aiMatrix4x4 &)> processNode =
         [&](const aiNode *p_node, const aiMatrix4x4 &parentTransform) {
             aiMatrix4x4 current = parentTransform * p_node->mTransformation;
@@ -92,7 +432,8 @@ void Scene::loadFromAssimp(const AssimpLoadParams &params)
             for (std::size_t i = 0; i < p_node->mNumMeshes; ++i) {
                 dynasma::FirmPtr<Model> p_model = modelById[p_node->mMeshes[i]];
 
-                modelProps.emplace_back(ModelProp{p_model, transf});
+                addModelProp(p_model, transf);
+                propMeshIndices.push_back(p_node->mMeshes[i]);
             }
 
             for (std::size_t i = 0; i < p_node->mNumChildren; ++i) {
@@ -100,11 +441,15 @@ void Scene::loadFromAssimp(const AssimpLoadParams &params)
             }
         };
 
-    processNode(params.p_extScene->mRootNode, aiMatrix4x4());
+    processNode(extScene.mRootNode, aiMatrix4x4());
+
+    return propMeshIndices;
+}
 
-    // load the camera
-    if (params.p_extScene->HasCameras()) {
-        const aiCamera *p_ext_camera = params.p_extScene->mCameras[0];
+void Scene::loadCameraFromAssimp(const aiScene &extScene)
+{
+    if (extScene.HasCameras()) {
+        const aiCamera *p_ext_camera = extScene.mCameras[0];
 
         camera.position = glm::vec3(p_ext_camera->mPosition.x, p_ext_camera->mPosition.y,
                                     p_ext_camera->mPosition.z);
@@ -116,6 +461,194 @@ void Scene::loadFromAssimp(const AssimpLoadParams &params)
     }
 }
 
+bool Scene::continueStreaming(std::chrono::steady_clock::duration timeBudget)
+{
+    if (!mp_streamingState) {
+        return false;
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + timeBudget;
+    StreamingState &state = *mp_streamingState;
+
+    if (state.pendingImport.valid()) {
+        if (state.pendingImport.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            return true;
+        }
+
+        try {
+            state.imported = state.pendingImport.get();
+        }
+        catch (...) {
+            mp_streamingState.reset();
+            throw;
+        }
+
+        state.root.getErrStream() << state.imported.errors;
+        if (!state.imported.p_extScene) {
+            mp_streamingState.reset();
+            return false;
+        }
+
+        addStreamedPlaceholders();
+    }
+
+    // the loading order is only updated once the camera moves far enough, or after a while for
+    // moved props, since it needs the boxes of all props with pending meshes
+    if (!state.priorityCameraPosition.has_value() ||
+        glm::length(camera.position - state.priorityCameraPosition.value()) >
+            state.params.reprioritizeDistance ||
+        state.callsSincePriorityUpdate >= state.params.reprioritizeInterval) {
+        updateStreamedMeshDistances();
+    }
+    ++state.callsSincePriorityUpdate;
+
+    // the meshes expected to load within the budget are selected, with the closest at the back
+    auto selectBatch = [&]() {
+        std::size_t batchSize = 1;
+        if (state.totalLoadTime.count() > 0 && timeBudget.count() > 0) {
+            batchSize += static_cast<std::size_t>(timeBudget * state.numLoadedMeshes /
+                                                  state.totalLoadTime);
+        }
+        batchSize = std::min(batchSize, state.pendingMeshes.size());
+
+        std::partial_sort(state.pendingMeshes.rbegin(), state.pendingMeshes.rbegin() + batchSize,
+                          state.pendingMeshes.rend(), [&](std::uint32_t a, std::uint32_t b) {
+                              return state.meshDistances[a] < state.meshDistances[b];
+                          });
+        state.numSelectedMeshes = batchSize;
+    };
+
+    bool loadedAny = false;
+    while (!state.pendingMeshes.empty() &&
+           (!loadedAny || std::chrono::steady_clock::now() < deadline)) {
+        if (state.numSelectedMeshes == 0) {
+            selectBatch();
+        }
+
+        std::uint32_t meshIndex = state.pendingMeshes.back();
+        state.pendingMeshes.pop_back();
+        --state.numSelectedMeshes;
+
+        auto loadStart = std::chrono::steady_clock::now();
+        loadStreamedModel(meshIndex);
+        state.totalLoadTime += std::chrono::steady_clock::now() - loadStart;
+        ++state.numLoadedMeshes;
+
+        loadedAny = true;
+    }
+
+    if (state.pendingMeshes.empty()) {
+        // releases the imported scene
+        mp_streamingState.reset();
+        return false;
+    }
+
+    return true;
+}
+
+void Scene::updateStreamedMeshDistances()
+{
+    StreamingState &state = *mp_streamingState;
+
+    state.meshDistances.assign(state.modelById.size(), std::numeric_limits<float>::max());
+    for (std::uint32_t meshIndex : state.pendingMeshes) {
+        const BoundingBox &modelBox = state.modelById[meshIndex]->getBoundingBox();
+
+        for (std::size_t transformIndex : state.transformIndicesByMesh[meshIndex]) {
+            if (transformIndex >= propTransforms.count()) {
+                continue;
+            }
+
+            BoundingBox box = transformed(propTransforms.getModelMatrix(transformIndex), modelBox);
+            glm::vec3 offset = glm::clamp(camera.position, box.min, box.max) - camera.position;
+            state.meshDistances[meshIndex] =
+                std::min(state.meshDistances[meshIndex], glm::length(offset));
+        }
+    }
+
+    state.priorityCameraPosition = camera.position;
+    state.callsSincePriorityUpdate = 0;
+    state.numSelectedMeshes = 0;
+}
+
+void Scene::addStreamedPlaceholders()
+{
+    StreamingState &state = *mp_streamingState;
+    const aiScene &extScene = *state.imported.p_extScene;
+
+    std::size_t numMeshes = extScene.HasMeshes() ? extScene.mNumMeshes : 0;
+    state.matById.resize(extScene.HasMaterials() ? extScene.mNumMaterials : 0);
+
+    // placeholder models, with the bounding boxes of their meshes so they are culled correctly
+    state.modelById.reserve(numMeshes);
+    for (std::size_t i = 0; i < numMeshes; ++i) {
+        const aiAABB &extBox = extScene.mMeshes[i]->mAABB;
+        BoundingBox box = {
+            .min = {extBox.mMin.x, extBox.mMin.y, extBox.mMin.z},
+            .max = {extBox.mMax.x, extBox.mMax.y, extBox.mMax.z},
+        };
+        glm::vec3 extent = box.getExtent();
+
+        dynasma::FirmPtr<Model> p_model = dynasma::makeStandalone<Model>(Model::FormParams{
+            .root = state.root,
+            .p_material = state.params.p_placeholderMaterial,
+            .boundingBox = box,
+        });
+
+        // the placeholder stands in for the whole mesh, so it's as detailed as the mesh's size
+        p_model->addForm("visual",
+                         std::shared_ptr<LoDMeasure>(new SmallestElementSizeMeasure(
+                             std::max(extent.x, std::max(extent.y, extent.z)))),
+                         state.params.p_placeholderShape);
+
+        state.modelById.emplace_back(p_model);
+    }
+
+    std::size_t firstPropIndex = modelProps.size();
+    std::vector<std::uint32_t> propMeshIndices = addPropsFromAssimp(extScene, state.modelById);
+
+    state.transformIndicesByMesh.resize(numMeshes);
+    for (std::size_t i = 0; i < propMeshIndices.size(); ++i) {
+        state.transformIndicesByMesh[propMeshIndices[i]].push_back(
+            modelProps[firstPropIndex + i].transformIndex);
+    }
+
+    rebuildPropHierarchy();
+    loadCameraFromAssimp(extScene);
+
+    state.pendingMeshes.resize(numMeshes);
+    std::iota(state.pendingMeshes.begin(), state.pendingMeshes.end(), 0);
+}
+
+void Scene::loadStreamedModel(std::uint32_t meshIndex)
+{
+    StreamingState &state = *mp_streamingState;
+    const aiScene &extScene = *state.imported.p_extScene;
+    const aiMesh *p_extMesh = extScene.mMeshes[meshIndex];
+
+    // materials are loaded along with their first model, while the imported scene still exists
+    dynasma::LazyPtr<Material> &p_mat = state.matById[p_extMesh->mMaterialIndex];
+    if (p_mat == dynasma::LazyPtr<Material>()) {
+        MaterialKeeper &matKeeper = state.root.getComponent<MaterialKeeper>();
+        p_mat = matKeeper
+                    .new_asset({
+                        Material::AssimpLoadParams{state.root,
+                                                   extScene.mMaterials[p_extMesh->mMaterialIndex],
+                                                   state.sceneFilepath},
+                    })
+                    .getLoaded();
+    }
+
+    // the props keep the model, so its forms are replaced in place
+    const dynasma::FirmPtr<Model> &p_model = state.modelById[meshIndex];
+    p_model->loadVisualFormFromAssimp({
+        .root = state.root,
+        .p_extMesh = p_extMesh,
+        .minEdgeLength = state.imported.meshMinEdgeLengths[meshIndex],
+    });
+    p_model->setMaterial(p_mat);
+}
+
 glm::mat4 DirectionalLight::getViewMatrix(const Camera &cam, float shadow_distance,
                                           float roundingStep)
 {
@@ -0,0 +1,621 @@
+#include "Vitrae/Assets/SceneCache.hpp"
+#include "Vitrae/Util/Hashing.hpp"
+
+#include "assimp/material.h"
+#include "assimp/mesh.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+
+namespace Vitrae
+{
+
+namespace
+{
+constexpr char CACHE_MAGIC[8] = {'V', 'I', 'T', 'R', 'S', 'C', 'N', '\0'};
+
+/**
+ * Bits of the mesh layout, telling which of the optional vertex arrays are stored
+ */
+constexpr std::uint32_t LAYOUT_NORMALS = 1 << 0;
+constexpr std::uint32_t LAYOUT_TANGENTS = 1 << 1;
+constexpr std::uint32_t LAYOUT_FIRST_COLOR_SET = 1 << 2;
+constexpr std::uint32_t LAYOUT_FIRST_TEXTURE_COORDS = LAYOUT_FIRST_COLOR_SET
+                                                      << AI_MAX_NUMBER_OF_COLOR_SETS;
+
+static_assert(AI_MAX_NUMBER_OF_COLOR_SETS + AI_MAX_NUMBER_OF_TEXTURECOORDS + 2 <= 32,
+              "Mesh layout doesn't fit into 32 bits");
+
+/**
+ * The alignment of the vertex and index arrays in the file, so they can be used in place
+ */
+constexpr std::size_t ARRAY_ALIGNMENT = 16;
+
+class CacheWriter
+{
+  public:
+    CacheWriter(const std::filesystem::path &filepath)
+        : m_file(filepath, std::ios::binary), m_offset(0)
+    {
+        if (!m_file) {
+            throw std::runtime_error("Failed to open " + filepath.string() + " for writing");
+        }
+    }
+
+    template <class T> void write(const T &value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        writeBytes(&value, sizeof(T));
+    }
+
+    template <class T> void writeArray(const T *p_values, std::size_t count)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        writeBytes(p_values, sizeof(T) * count);
+    }
+
+    void writeBytes(const void *p_data, std::size_t size)
+    {
+        m_file.write(static_cast<const char *>(p_data), static_cast<std::streamsize>(size));
+        m_offset += size;
+    }
+
+    /**
+     * Pads the file with zeros up to the alignment
+     */
+    void align(std::size_t alignment)
+    {
+        constexpr char zeros[ARRAY_ALIGNMENT] = {};
+        writeBytes(zeros, (alignment - m_offset % alignment) % alignment);
+    }
+
+    void writeString(const aiString &str)
+    {
+        write<std::uint32_t>(str.length);
+        writeBytes(str.data, str.length);
+    }
+
+    void finish()
+    {
+        m_file.close();
+        if (!m_file) {
+            throw std::runtime_error("Failed to write the scene cache");
+        }
+    }
+
+  private:
+    std::ofstream m_file;
+    std::size_t m_offset;
+};
+
+class CacheReader
+{
+  public:
+    CacheReader(std::byte *p_data, std::size_t size) : mp_data(p_data), m_size(size), m_offset(0)
+    {}
+
+    template <class T> T read()
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        T value;
+        std::memcpy(&value, readBytes(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    /**
+     * @returns A new[] allocated array of the values
+     */
+    template <class T> T *readArray(std::size_t count)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+
+        // checked before allocating, so corrupted counts don't allocate huge arrays
+        if (count > remaining() / sizeof(T)) {
+            throw std::runtime_error("Scene cache is truncated");
+        }
+        T *p_values = new T[count];
+        std::memcpy(p_values, readBytes(sizeof(T) * count), sizeof(T) * count);
+        return p_values;
+    }
+
+    /**
+     * @returns The array of the values in place, valid as long as the read data
+     */
+    template <class T> T *borrowArray(std::size_t count)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+
+        if (count > remaining() / sizeof(T)) {
+            throw std::runtime_error("Scene cache is truncated");
+        }
+        std::byte *p_bytes = readBytes(sizeof(T) * count);
+        if (reinterpret_cast<std::uintptr_t>(p_bytes) % alignof(T) != 0) {
+            throw std::runtime_error("Scene cache has a misaligned array");
+        }
+        // the data is an array of bytes, which implicitly created the values
+        return reinterpret_cast<T *>(p_bytes);
+    }
+
+    /**
+     * @returns The bytes in the read data
+     */
+    std::byte *readBytes(std::size_t size)
+    {
+        if (size > remaining()) {
+            throw std::runtime_error("Scene cache is truncated");
+        }
+        std::byte *p_bytes = mp_data + m_offset;
+        m_offset += size;
+        return p_bytes;
+    }
+
+    /**
+     * Skips the padding up to the alignment
+     */
+    void align(std::size_t alignment) { readBytes((alignment - m_offset % alignment) % alignment); }
+
+    void readString(aiString &outStr)
+    {
+        std::uint32_t length = read<std::uint32_t>();
+        if (length >= sizeof(outStr.data)) {
+            throw std::runtime_error("Scene cache has a string that is too long");
+        }
+        std::memcpy(outStr.data, readBytes(length), length);
+        outStr.data[length] = '\0';
+        outStr.length = length;
+    }
+
+    inline std::size_t remaining() const { return m_size - m_offset; }
+
+  private:
+    std::byte *mp_data;
+    std::size_t m_size;
+    std::size_t m_offset;
+};
+
+void writeMesh(CacheWriter &writer, const aiMesh &extMesh, float minEdgeLength)
+{
+    // meshes are triangulated and split by primitive type, so their faces are the same size
+    std::uint32_t numFaceIndices = extMesh.mNumFaces > 0 ? extMesh.mFaces[0].mNumIndices : 0;
+    for (unsigned int i = 0; i < extMesh.mNumFaces; ++i) {
+        if (extMesh.mFaces[i].mNumIndices != numFaceIndices) {
+            throw std::invalid_argument("Scene cache needs faces of the same size in each mesh");
+        }
+    }
+
+    writer.writeString(extMesh.mName);
+    writer.write<std::uint32_t>(extMesh.mPrimitiveTypes);
+    writer.write<std::uint32_t>(extMesh.mMaterialIndex);
+    writer.write<std::uint32_t>(extMesh.mNumVertices);
+    writer.write<std::uint32_t>(extMesh.mNumFaces);
+    writer.write(numFaceIndices);
+    writer.write(extMesh.mAABB);
+    writer.write(minEdgeLength);
+
+    std::uint32_t layout = 0;
+    if (extMesh.mNormals) {
+        layout |= LAYOUT_NORMALS;
+    }
+    if (extMesh.mTangents && extMesh.mBitangents) {
+        layout |= LAYOUT_TANGENTS;
+    }
+    for (unsigned int i = 0; i < AI_MAX_NUMBER_OF_COLOR_SETS; ++i) {
+        if (extMesh.mColors[i]) {
+            layout |= LAYOUT_FIRST_COLOR_SET << i;
+        }
+    }
+    for (unsigned int i = 0; i < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++i) {
+        if (extMesh.mTextureCoords[i]) {
+            layout |= LAYOUT_FIRST_TEXTURE_COORDS << i;
+        }
+    }
+    writer.write(layout);
+    for (unsigned int i = 0; i < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++i) {
+        if (layout & (LAYOUT_FIRST_TEXTURE_COORDS << i)) {
+            writer.write<std::uint32_t>(extMesh.mNumUVComponents[i]);
+        }
+    }
+
+    // every array is aligned, so it can be used in place when read
+    auto writeVertexArray = [&](const auto *p_values) {
+        writer.align(ARRAY_ALIGNMENT);
+        writer.writeArray(p_values, extMesh.mNumVertices);
+    };
+
+    writeVertexArray(extMesh.mVertices);
+    if (layout & LAYOUT_NORMALS) {
+        writeVertexArray(extMesh.mNormals);
+    }
+    if (layout & LAYOUT_TANGENTS) {
+        writeVertexArray(extMesh.mTangents);
+        writeVertexArray(extMesh.mBitangents);
+    }
+    for (unsigned int i = 0; i < AI_MAX_NUMBER_OF_COLOR_SETS; ++i) {
+        if (layout & (LAYOUT_FIRST_COLOR_SET << i)) {
+            writeVertexArray(extMesh.mColors[i]);
+        }
+    }
+    for (unsigned int i = 0; i < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++i) {
+        if (layout & (LAYOUT_FIRST_TEXTURE_COORDS << i)) {
+            writeVertexArray(extMesh.mTextureCoords[i]);
+        }
+    }
+
+    // the indices of all faces in one array
+    writer.align(ARRAY_ALIGNMENT);
+    for (unsigned int i = 0; i < extMesh.mNumFaces; ++i) {
+        writer.writeArray(extMesh.mFaces[i].mIndices, numFaceIndices);
+    }
+}
+
+/**
+ * Reads the mesh into the scene's mesh, borrowing its vertex and index arrays from the read data
+ */
+void readMesh(CacheReader &reader, aiMesh &extMesh, unsigned int numMaterials,
+              float &outMinEdgeLength)
+{
+    reader.readString(extMesh.mName);
+    extMesh.mPrimitiveTypes = reader.read<std::uint32_t>();
+    extMesh.mMaterialIndex = reader.read<std::uint32_t>();
+    std::uint32_t numVertices = reader.read<std::uint32_t>();
+    std::uint32_t numFaces = reader.read<std::uint32_t>();
+    std::uint32_t numFaceIndices = reader.read<std::uint32_t>();
+    extMesh.mAABB = reader.read<aiAABB>();
+    outMinEdgeLength = reader.read<float>();
+    std::uint32_t layout = reader.read<std::uint32_t>();
+    for (unsigned int i = 0; i < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++i) {
+        if (layout & (LAYOUT_FIRST_TEXTURE_COORDS << i)) {
+            extMesh.mNumUVComponents[i] = reader.read<std::uint32_t>();
+        }
+    }
+
+    if (extMesh.mMaterialIndex >= numMaterials) {
+        throw std::runtime_error("Scene cache has a mesh with an invalid material");
+    }
+
+    auto borrowVertexArray = [&]<class T>(T *&p_outValues) {
+        reader.align(ARRAY_ALIGNMENT);
+        p_outValues = reader.borrowArray<T>(numVertices);
+    };
+
+    borrowVertexArray(extMesh.mVertices);
+    extMesh.mNumVertices = numVertices;
+    if (layout & LAYOUT_NORMALS) {
+        borrowVertexArray(extMesh.mNormals);
+    }
+    if (layout & LAYOUT_TANGENTS) {
+        borrowVertexArray(extMesh.mTangents);
+        borrowVertexArray(extMesh.mBitangents);
+    }
+    for (unsigned int i = 0; i < AI_MAX_NUMBER_OF_COLOR_SETS; ++i) {
+        if (layout & (LAYOUT_FIRST_COLOR_SET << i)) {
+            borrowVertexArray(extMesh.mColors[i]);
+        }
+    }
+    for (unsigned int i = 0; i < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++i) {
+        if (layout & (LAYOUT_FIRST_TEXTURE_COORDS << i)) {
+            borrowVertexArray(extMesh.mTextureCoords[i]);
+        }
+    }
+
+    // counted in 64 bits, so corrupted counts can't overflow
+    reader.align(ARRAY_ALIGNMENT);
+    unsigned int *p_indices =
+        reader.borrowArray<unsigned int>(std::uint64_t(numFaces) * numFaceIndices);
+    for (std::uint64_t i = 0; i < std::uint64_t(numFaces) * numFaceIndices; ++i) {
+        if (p_indices[i] >= numVertices) {
+            throw std::runtime_error("Scene cache has a face with an invalid vertex");
+        }
+    }
+
+    // assimp needs a face array, but the faces point into the borrowed indices
+    extMesh.mFaces = new aiFace[numFaces];
+    extMesh.mNumFaces = numFaces;
+    for (std::uint32_t i = 0; i < numFaces; ++i) {
+        extMesh.mFaces[i].mIndices = p_indices + std::size_t(i) * numFaceIndices;
+        extMesh.mFaces[i].mNumIndices = numFaceIndices;
+    }
+}
+
+/**
+ * Unsets the arrays borrowed from the read data, so the mesh doesn't free them
+ */
+void detachBorrowedArrays(aiMesh &extMesh)
+{
+    extMesh.mVertices = nullptr;
+    extMesh.mNormals = nullptr;
+    extMesh.mTangents = nullptr;
+    extMesh.mBitangents = nullptr;
+    for (auto &p_colors : extMesh.mColors) {
+        p_colors = nullptr;
+    }
+    for (auto &p_textureCoords : extMesh.mTextureCoords) {
+        p_textureCoords = nullptr;
+    }
+    for (unsigned int i = 0; i < extMesh.mNumFaces; ++i) {
+        extMesh.mFaces[i].mIndices = nullptr;
+    }
+}
+
+void writeMaterial(CacheWriter &writer, const aiMaterial &extMaterial)
+{
+    writer.write<std::uint32_t>(extMaterial.mNumProperties);
+    for (unsigned int i = 0; i < extMaterial.mNumProperties; ++i) {
+        const aiMaterialProperty &property = *extMaterial.mProperties[i];
+        writer.writeString(property.mKey);
+        writer.write<std::uint32_t>(property.mSemantic);
+        writer.write<std::uint32_t>(property.mIndex);
+        writer.write<std::uint32_t>(property.mType);
+        writer.write<std::uint32_t>(property.mDataLength);
+        writer.writeBytes(property.mData, property.mDataLength);
+    }
+}
+
+std::unique_ptr<aiMaterial> readMaterial(CacheReader &reader)
+{
+    auto p_extMaterial = std::make_unique<aiMaterial>();
+
+    std::uint32_t numProperties = reader.read<std::uint32_t>();
+    for (std::uint32_t i = 0; i < numProperties; ++i) {
+        aiString key;
+        reader.readString(key);
+        std::uint32_t semantic = reader.read<std::uint32_t>();
+        std::uint32_t index = reader.read<std::uint32_t>();
+        std::uint32_t type = reader.read<std::uint32_t>();
+        std::uint32_t dataLength = reader.read<std::uint32_t>();
+
+        // the raw data is stored, so it is added as binary whatever its type
+        p_extMaterial->AddBinaryProperty(reader.readBytes(dataLength), dataLength, key.C_Str(),
+                                         semantic, index,
+                                         static_cast<aiPropertyTypeInfo>(type));
+    }
+
+    return p_extMaterial;
+}
+
+void writeNode(CacheWriter &writer, const aiNode &extNode)
+{
+    writer.writeString(extNode.mName);
+    writer.write(extNode.mTransformation);
+    writer.write<std::uint32_t>(extNode.mNumMeshes);
+    writer.writeArray(extNode.mMeshes, extNode.mNumMeshes);
+
+    writer.write<std::uint32_t>(extNode.mNumChildren);
+    for (unsigned int i = 0; i < extNode.mNumChildren; ++i) {
+        writeNode(writer, *extNode.mChildren[i]);
+    }
+}
+
+std::unique_ptr<aiNode> readNode(CacheReader &reader, unsigned int numMeshes)
+{
+    auto p_extNode = std::make_unique<aiNode>();
+
+    reader.readString(p_extNode->mName);
+    p_extNode->mTransformation = reader.read<aiMatrix4x4>();
+    std::uint32_t numNodeMeshes = reader.read<std::uint32_t>();
+    p_extNode->mMeshes = reader.readArray<unsigned int>(numNodeMeshes);
+    p_extNode->mNumMeshes = numNodeMeshes;
+
+    for (std::uint32_t i = 0; i < numNodeMeshes; ++i) {
+        if (p_extNode->mMeshes[i] >= numMeshes) {
+            throw std::runtime_error("Scene cache has a node with an invalid mesh");
+        }
+    }
+
+    std::uint32_t numChildren = reader.read<std::uint32_t>();
+    if (numChildren > reader.remaining()) {
+        throw std::runtime_error("Scene cache is truncated");
+    }
+    p_extNode->mChildren = new aiNode *[numChildren];
+    for (std::uint32_t i = 0; i < numChildren; ++i) {
+        // counted as they are read, so the node frees them if a later one fails
+        aiNode *p_child = readNode(reader, numMeshes).release();
+        p_child->mParent = p_extNode.get();
+        p_extNode->mChildren[p_extNode->mNumChildren++] = p_child;
+    }
+
+    return p_extNode;
+}
+
+void writeCamera(CacheWriter &writer, const aiCamera &extCamera)
+{
+    writer.writeString(extCamera.mName);
+    writer.write(extCamera.mPosition);
+    writer.write(extCamera.mUp);
+    writer.write(extCamera.mLookAt);
+    writer.write(extCamera.mHorizontalFOV);
+    writer.write(extCamera.mClipPlaneNear);
+    writer.write(extCamera.mClipPlaneFar);
+    writer.write(extCamera.mAspect);
+}
+
+std::unique_ptr<aiCamera> readCamera(CacheReader &reader)
+{
+    auto p_extCamera = std::make_unique<aiCamera>();
+
+    reader.readString(p_extCamera->mName);
+    p_extCamera->mPosition = reader.read<aiVector3D>();
+    p_extCamera->mUp = reader.read<aiVector3D>();
+    p_extCamera->mLookAt = reader.read<aiVector3D>();
+    p_extCamera->mHorizontalFOV = reader.read<float>();
+    p_extCamera->mClipPlaneNear = reader.read<float>();
+    p_extCamera->mClipPlaneFar = reader.read<float>();
+    p_extCamera->mAspect = reader.read<float>();
+
+    return p_extCamera;
+}
+} // namespace
+
+CachedScene::~CachedScene()
+{
+    // the borrowed arrays are freed with the read data instead
+    if (mp_extScene) {
+        for (unsigned int i = 0; i < mp_extScene->mNumMeshes; ++i) {
+            detachBorrowedArrays(*mp_extScene->mMeshes[i]);
+        }
+    }
+}
+
+std::uint64_t computeSceneCacheKey(const std::filesystem::path &sourceFilepath,
+                                   unsigned int importFlags)
+{
+    std::ifstream file(sourceFilepath, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Failed to open " + sourceFilepath.string());
+    }
+
+    StreamingHash hash;
+    hash.add(SCENE_CACHE_VERSION);
+    hash.add(importFlags);
+
+    std::vector<char> chunk(1 << 20);
+    std::uint64_t fileSize = 0;
+    while (file) {
+        file.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        std::size_t chunkSize = static_cast<std::size_t>(file.gcount());
+
+        for (std::size_t offset = 0; offset < chunkSize; offset += sizeof(std::uint64_t)) {
+            std::uint64_t word = 0;
+            std::memcpy(&word, chunk.data() + offset,
+                        std::min(sizeof(std::uint64_t), chunkSize - offset));
+            hash.add(word);
+        }
+        fileSize += chunkSize;
+    }
+    if (file.bad()) {
+        throw std::runtime_error("Failed to read " + sourceFilepath.string());
+    }
+    hash.add(fileSize);
+
+    return hash.get();
+}
+
+void writeSceneCache(const std::filesystem::path &cacheFilepath, std::uint64_t key,
+                     const aiScene &extScene, std::span<const float> meshMinEdgeLengths)
+{
+    unsigned int numMeshes = extScene.HasMeshes() ? extScene.mNumMeshes : 0;
+    unsigned int numMaterials = extScene.HasMaterials() ? extScene.mNumMaterials : 0;
+    unsigned int numCameras = extScene.HasCameras() ? extScene.mNumCameras : 0;
+
+    if (meshMinEdgeLengths.size() != numMeshes) {
+        throw std::invalid_argument("Scene cache needs the edge lengths of all meshes");
+    }
+
+    // written next to the cache and then moved over it, so readers never see a partial file
+    std::filesystem::path tempFilepath = cacheFilepath;
+    tempFilepath += ".tmp";
+
+    if (cacheFilepath.has_parent_path()) {
+        std::filesystem::create_directories(cacheFilepath.parent_path());
+    }
+
+    {
+        CacheWriter writer(tempFilepath);
+
+        writer.write(CACHE_MAGIC);
+        writer.write(SCENE_CACHE_VERSION);
+        writer.write<std::uint32_t>(sizeof(ai_real));
+        writer.write(key);
+
+        writer.write<std::uint32_t>(numMaterials);
+        for (unsigned int i = 0; i < numMaterials; ++i) {
+            writeMaterial(writer, *extScene.mMaterials[i]);
+        }
+
+        writer.write<std::uint32_t>(numMeshes);
+        for (unsigned int i = 0; i < numMeshes; ++i) {
+            writeMesh(writer, *extScene.mMeshes[i], meshMinEdgeLengths[i]);
+        }
+
+        writeNode(writer, *extScene.mRootNode);
+
+        writer.write<std::uint32_t>(numCameras);
+        for (unsigned int i = 0; i < numCameras; ++i) {
+            writeCamera(writer, *extScene.mCameras[i]);
+        }
+
+        writer.finish();
+    }
+
+    std::filesystem::rename(tempFilepath, cacheFilepath);
+}
+
+std::unique_ptr<CachedScene> readSceneCache(const std::filesystem::path &cacheFilepath,
+                                            std::uint64_t key,
+                                            std::vector<float> &outMeshMinEdgeLengths)
+{
+    std::ifstream file(cacheFilepath, std::ios::binary | std::ios::ate);
+    if (!file) {
+        return nullptr;
+    }
+
+    // read at once and kept, since the meshes use their arrays in place
+    std::unique_ptr<CachedScene> p_cachedScene(new CachedScene());
+    std::size_t size = static_cast<std::size_t>(file.tellg());
+    p_cachedScene->mp_data = std::make_unique_for_overwrite<std::byte[]>(size);
+    file.seekg(0);
+    file.read(reinterpret_cast<char *>(p_cachedScene->mp_data.get()),
+              static_cast<std::streamsize>(size));
+    if (!file) {
+        throw std::runtime_error("Failed to read " + cacheFilepath.string());
+    }
+    file.close();
+
+    CacheReader reader(p_cachedScene->mp_data.get(), size);
+
+    // caches of other sources, versions or builds are outdated rather than corrupted
+    if (reader.remaining() < sizeof(CACHE_MAGIC) ||
+        std::memcmp(reader.readBytes(sizeof(CACHE_MAGIC)), CACHE_MAGIC, sizeof(CACHE_MAGIC)) !=
+            0) {
+        return nullptr;
+    }
+    if (reader.read<std::uint32_t>() != SCENE_CACHE_VERSION ||
+        reader.read<std::uint32_t>() != sizeof(ai_real) || reader.read<std::uint64_t>() != key) {
+        return nullptr;
+    }
+
+    // counts are raised as parts are read, so the scene frees them if a later one fails
+    p_cachedScene->mp_extScene = std::make_unique<aiScene>();
+    aiScene &extScene = *p_cachedScene->mp_extScene;
+
+    std::uint32_t numMaterials = reader.read<std::uint32_t>();
+    if (numMaterials > reader.remaining()) {
+        throw std::runtime_error("Scene cache is truncated");
+    }
+    extScene.mMaterials = new aiMaterial *[numMaterials];
+    for (std::uint32_t i = 0; i < numMaterials; ++i) {
+        extScene.mMaterials[extScene.mNumMaterials++] = readMaterial(reader).release();
+    }
+
+    std::uint32_t numMeshes = reader.read<std::uint32_t>();
+    if (numMeshes > reader.remaining()) {
+        throw std::runtime_error("Scene cache is truncated");
+    }
+    outMeshMinEdgeLengths.resize(numMeshes);
+    extScene.mMeshes = new aiMesh *[numMeshes];
+    for (std::uint32_t i = 0; i < numMeshes; ++i) {
+        // added before reading, so its borrowed arrays are detached if reading fails
+        aiMesh *p_extMesh = new aiMesh();
+        extScene.mMeshes[extScene.mNumMeshes++] = p_extMesh;
+        readMesh(reader, *p_extMesh, numMaterials, outMeshMinEdgeLengths[i]);
+    }
+
+    extScene.mRootNode = readNode(reader, numMeshes).release();
+
+    std::uint32_t numCameras = reader.read<std::uint32_t>();
+    if (numCameras > reader.remaining()) {
+        throw std::runtime_error("Scene cache is truncated");
+    }
+    extScene.mCameras = new aiCamera *[numCameras];
+    for (std::uint32_t i = 0; i < numCameras; ++i) {
+        extScene.mCameras[extScene.mNumCameras++] = readCamera(reader).release();
+    }
+
+    return p_cachedScene;
+}
+
+} // namespace Vitrae
\ No newline at end of file
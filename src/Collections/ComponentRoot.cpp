@@ -4,7 +4,9 @@
 #include "Vitrae/Collections/FormGenerator.hpp"
 #include "Vitrae/Collections/MeshGenerator.hpp"
 #include "Vitrae/Collections/MethodCollection.hpp"
+#include "Vitrae/Debugging/PipelineDebugSink.hpp"
 #include "Vitrae/Params/Standard.hpp"
+#include "Vitrae/Pipelines/PipelineCache.hpp"
 
 #include <iostream>
 
@@ -46,6 +48,8 @@ ComponentRoot::ComponentRoot()
     setComponent<MethodCollection>(new MethodCollection);
     setComponent<FormGeneratorCollection>(new FormGeneratorCollection);
     setComponent<MeshGeneratorCollection>(new MeshGeneratorCollection);
+    setComponent<PipelineCache<ComposeTask>>(new PipelineCache<ComposeTask>);
+    setComponent<PipelineDebugSink>(new PipelineDebugSink);
 }
 
 ComponentRoot::~ComponentRoot()
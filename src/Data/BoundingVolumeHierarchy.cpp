@@ -0,0 +1,177 @@
+#include "Vitrae/Data/BoundingVolumeHierarchy.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace Vitrae
+{
+
+void BoundingVolumeHierarchy::build(std::span<const BoundingBox> boxes)
+{
+    clear();
+
+    m_itemIndices.resize(boxes.size());
+    std::iota(m_itemIndices.begin(), m_itemIndices.end(), 0);
+    m_itemSlots.resize(boxes.size());
+
+    if (!boxes.empty()) {
+        m_nodes.reserve(boxes.size() / (WIDTH - 1) + 1);
+        m_parentSlots.reserve(boxes.size() / (WIDTH - 1) + 1);
+        m_nodes.emplace_back();
+        m_parentSlots.push_back(NO_NODE);
+        buildNode(0, 0, static_cast<std::uint32_t>(boxes.size()), boxes);
+    }
+
+    m_nodeDirtyFlags.assign(m_nodes.size(), 0);
+}
+
+void BoundingVolumeHierarchy::refit(std::span<const std::uint32_t> items,
+                                    std::span<const BoundingBox> boxes)
+{
+    for (std::size_t i = 0; i < items.size(); ++i) {
+        std::uint32_t slot = m_itemSlots[items[i]];
+        setChildBox(m_nodes[slot / WIDTH], slot % WIDTH, boxes[i]);
+
+        // mark the ancestors, up to the ones already marked for other items
+        std::uint32_t nodeIndex = slot / WIDTH;
+        while (nodeIndex != NO_NODE && !m_nodeDirtyFlags[nodeIndex]) {
+            m_nodeDirtyFlags[nodeIndex] = 1;
+            std::uint32_t parentSlot = m_parentSlots[nodeIndex];
+            nodeIndex = parentSlot == NO_NODE ? NO_NODE : parentSlot / WIDTH;
+        }
+    }
+
+    // children are stored after their parents, so going backwards updates them first
+    for (std::size_t nodeIndex = m_nodes.size(); nodeIndex-- > 0;) {
+        if (m_nodeDirtyFlags[nodeIndex]) {
+            m_nodeDirtyFlags[nodeIndex] = 0;
+
+            if (std::uint32_t parentSlot = m_parentSlots[nodeIndex]; parentSlot != NO_NODE) {
+                setChildBox(m_nodes[parentSlot / WIDTH], parentSlot % WIDTH,
+                            getNodeBox(m_nodes[nodeIndex]));
+            }
+        }
+    }
+}
+
+void BoundingVolumeHierarchy::clear()
+{
+    m_nodes.clear();
+    m_itemIndices.clear();
+    m_parentSlots.clear();
+    m_itemSlots.clear();
+    m_nodeDirtyFlags.clear();
+}
+
+void BoundingVolumeHierarchy::setChildBox(Node &node, std::uint32_t lane, const BoundingBox &box)
+{
+    node.minX[lane] = box.min.x;
+    node.minY[lane] = box.min.y;
+    node.minZ[lane] = box.min.z;
+    node.maxX[lane] = box.max.x;
+    node.maxY[lane] = box.max.y;
+    node.maxZ[lane] = box.max.z;
+}
+
+BoundingBox BoundingVolumeHierarchy::getNodeBox(const Node &node)
+{
+    BoundingBox box{
+        .min = {node.minX[0], node.minY[0], node.minZ[0]},
+        .max = {node.maxX[0], node.maxY[0], node.maxZ[0]},
+    };
+    for (std::uint32_t lane = 1; lane < node.childCount; ++lane) {
+        box.merge(BoundingBox{
+            .min = {node.minX[lane], node.minY[lane], node.minZ[lane]},
+            .max = {node.maxX[lane], node.maxY[lane], node.maxZ[lane]},
+        });
+    }
+    return box;
+}
+
+BoundingBox BoundingVolumeHierarchy::buildNode(std::uint32_t nodeIndex, std::uint32_t firstItem,
+                                               std::uint32_t itemCount,
+                                               std::span<const BoundingBox> boxes)
+{
+    // splits the range in half by the centers of the boxes, along the axis they spread the most
+    auto splitRange = [&](std::uint32_t first, std::uint32_t count) {
+        auto itBegin = m_itemIndices.begin() + first;
+        auto itEnd = itBegin + count;
+
+        glm::vec3 centerMin = boxes[*itBegin].getCenter();
+        glm::vec3 centerMax = centerMin;
+        for (auto it = itBegin; it != itEnd; ++it) {
+            glm::vec3 center = boxes[*it].getCenter();
+            centerMin = glm::min(centerMin, center);
+            centerMax = glm::max(centerMax, center);
+        }
+
+        glm::vec3 spread = centerMax - centerMin;
+        int axis = spread.x >= spread.y && spread.x >= spread.z ? 0 : spread.y >= spread.z ? 1 : 2;
+
+        std::uint32_t half = count / 2;
+        std::nth_element(itBegin, itBegin + half, itEnd, [&](std::uint32_t a, std::uint32_t b) {
+            return boxes[a].min[axis] + boxes[a].max[axis] <
+                   boxes[b].min[axis] + boxes[b].max[axis];
+        });
+        return half;
+    };
+
+    // the item ranges of the children
+    std::uint32_t partFirst[WIDTH];
+    std::uint32_t partCount[WIDTH];
+    std::uint32_t partNum;
+
+    if (itemCount <= WIDTH) {
+        for (partNum = 0; partNum < itemCount; ++partNum) {
+            partFirst[partNum] = firstItem + partNum;
+            partCount[partNum] = 1;
+        }
+    } else {
+        std::uint32_t half = splitRange(firstItem, itemCount);
+        std::uint32_t firstQuarter = splitRange(firstItem, half);
+        std::uint32_t thirdQuarter = splitRange(firstItem + half, itemCount - half);
+
+        partFirst[0] = firstItem;
+        partCount[0] = firstQuarter;
+        partFirst[1] = firstItem + firstQuarter;
+        partCount[1] = half - firstQuarter;
+        partFirst[2] = firstItem + half;
+        partCount[2] = thirdQuarter;
+        partFirst[3] = firstItem + half + thirdQuarter;
+        partCount[3] = itemCount - half - thirdQuarter;
+        partNum = WIDTH;
+    }
+
+    BoundingBox nodeBox = boxes[m_itemIndices[firstItem]];
+
+    for (std::uint32_t lane = 0; lane < partNum; ++lane) {
+        BoundingBox childBox;
+        std::uint32_t childNode;
+
+        if (partCount[lane] == 1) {
+            std::uint32_t item = m_itemIndices[partFirst[lane]];
+            childBox = boxes[item];
+            childNode = NO_NODE;
+            m_itemSlots[item] = nodeIndex * WIDTH + lane;
+        } else {
+            childNode = static_cast<std::uint32_t>(m_nodes.size());
+            m_nodes.emplace_back();
+            m_parentSlots.push_back(nodeIndex * WIDTH + lane);
+            childBox = buildNode(childNode, partFirst[lane], partCount[lane], boxes);
+        }
+
+        // building children adds nodes, so the node is only referenced afterwards
+        Node &node = m_nodes[nodeIndex];
+        setChildBox(node, lane, childBox);
+        node.firstItem[lane] = partFirst[lane];
+        node.itemCount[lane] = partCount[lane];
+        node.childNode[lane] = childNode;
+
+        nodeBox.merge(childBox);
+    }
+    m_nodes[nodeIndex].childCount = partNum;
+
+    return nodeBox;
+}
+
+} // namespace Vitrae
\ No newline at end of file
@@ -0,0 +1,37 @@
+#include "Vitrae/Data/Frustum.hpp"
+
+namespace Vitrae
+{
+
+Frustum Frustum::fromViewProjection(const glm::mat4 &viewProjection)
+{
+    // glm matrices are column major, so rows are gathered from the columns
+    auto row = [&](int i) {
+        return glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i],
+                         viewProjection[3][i]);
+    };
+
+    glm::vec4 x = row(0), y = row(1), z = row(2), w = row(3);
+
+    return Frustum{.planes = {w + x, w - x, w + y, w - y, w + z, w - z}};
+}
+
+bool Frustum::intersects(const BoundingBox &box) const
+{
+    for (const glm::vec4 &plane : planes) {
+        // the corner furthest along the plane normal
+        glm::vec3 corner = {
+            plane.x >= 0.0f ? box.max.x : box.min.x,
+            plane.y >= 0.0f ? box.max.y : box.min.y,
+            plane.z >= 0.0f ? box.max.z : box.min.z,
+        };
+
+        if (plane.x * corner.x + plane.y * corner.y + plane.z * corner.z + plane.w < 0.0f) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace Vitrae
\ No newline at end of file
@@ -0,0 +1,88 @@
+#include "Vitrae/Data/StringId.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdio>
+
+namespace Vitrae
+{
+
+std::size_t StringIdTable::s_hashes[StringIdTable::CAPACITY] = {};
+const char *StringIdTable::s_strings[StringIdTable::CAPACITY] = {};
+
+void StringIdTable::checkCollision(std::size_t slot, std::string_view str)
+{
+    // the string may still be being published by another thread; then we can't check
+    const char *p_str =
+        std::atomic_ref<const char *>(s_strings[slot]).load(std::memory_order_acquire);
+    if (p_str && std::string_view(p_str) != str) {
+        // stdio is usable during static initialization, unlike the iostreams
+        std::fprintf(stderr, "StringId hash collision between '%s' and '%.*s'\n", p_str,
+                     static_cast<int>(str.size()), str.data());
+        assert(false && "StringId hash collision");
+    }
+}
+
+void StringIdTable::intern(std::size_t hash, std::string_view str)
+{
+    if (hash == 0) {
+        return;
+    }
+
+    std::size_t slot = getHomeSlot(hash);
+    for (std::size_t probe = 0; probe < CAPACITY; ++probe) {
+        std::atomic_ref<std::size_t> slotHash(s_hashes[slot]);
+
+        std::size_t foundHash = slotHash.load(std::memory_order_acquire);
+        if (foundHash == hash) {
+            checkCollision(slot, str);
+            return;
+        }
+        if (foundHash == 0) {
+            if (slotHash.compare_exchange_strong(foundHash, hash, std::memory_order_acq_rel)) {
+                // we own the slot; publish the string. It is never freed
+                char *p_str = new char[str.size() + 1];
+                std::copy(str.begin(), str.end(), p_str);
+                p_str[str.size()] = '\0';
+                std::atomic_ref<const char *>(s_strings[slot]).store(p_str,
+                                                                     std::memory_order_release);
+                return;
+            }
+            if (foundHash == hash) {
+                checkCollision(slot, str);
+                return;
+            }
+        }
+        slot = (slot + 1) & (CAPACITY - 1);
+    }
+
+    // the table is full; the string won't be available for debugging
+}
+
+std::string_view StringIdTable::lookup(std::size_t hash)
+{
+    if (hash == 0) {
+        return {};
+    }
+
+    std::size_t slot = getHomeSlot(hash);
+    for (std::size_t probe = 0; probe < CAPACITY; ++probe) {
+        std::size_t foundHash =
+            std::atomic_ref<std::size_t>(s_hashes[slot]).load(std::memory_order_acquire);
+        if (foundHash == hash) {
+            // may still be null if the string is being published by another thread
+            const char *p_str =
+                std::atomic_ref<const char *>(s_strings[slot]).load(std::memory_order_acquire);
+            return p_str ? std::string_view(p_str) : std::string_view();
+        }
+        if (foundHash == 0) {
+            break;
+        }
+        slot = (slot + 1) & (CAPACITY - 1);
+    }
+
+    return {};
+}
+
+} // namespace Vitrae
\ No newline at end of file
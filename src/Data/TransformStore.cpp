@@ -0,0 +1,105 @@
+#include "Vitrae/Data/TransformStore.hpp"
+
+#include <algorithm>
+
+namespace Vitrae
+{
+
+std::size_t TransformStore::add(const SimpleTransformation &transform)
+{
+    std::size_t index = m_positions.size();
+
+    m_positions.push_back(transform.position);
+    m_rotations.push_back(transform.rotation);
+    m_scalings.push_back(transform.scaling);
+    m_modelMatrices.emplace_back(1.0f);
+    m_dirtyFlags.push_back(0);
+    markDirty(index);
+
+    return index;
+}
+
+void TransformStore::clear()
+{
+    m_positions.clear();
+    m_rotations.clear();
+    m_scalings.clear();
+    m_modelMatrices.clear();
+    m_dirtyFlags.clear();
+    m_dirtyIndices.clear();
+}
+
+SimpleTransformation TransformStore::get(std::size_t index) const
+{
+    return SimpleTransformation{
+        .position = m_positions[index],
+        .rotation = m_rotations[index],
+        .scaling = m_scalings[index],
+    };
+}
+
+void TransformStore::set(std::size_t index, const SimpleTransformation &transform)
+{
+    m_positions[index] = transform.position;
+    m_rotations[index] = transform.rotation;
+    m_scalings[index] = transform.scaling;
+    markDirty(index);
+}
+
+void TransformStore::setPosition(std::size_t index, const glm::vec3 &position)
+{
+    m_positions[index] = position;
+    markDirty(index);
+}
+
+void TransformStore::setRotation(std::size_t index, const glm::quat &rotation)
+{
+    m_rotations[index] = rotation;
+    markDirty(index);
+}
+
+void TransformStore::setScaling(std::size_t index, const glm::vec3 &scaling)
+{
+    m_scalings[index] = scaling;
+    markDirty(index);
+}
+
+std::size_t TransformStore::updateMatrices()
+{
+    // in order of the storage, to access it sequentially
+    std::sort(m_dirtyIndices.begin(), m_dirtyIndices.end());
+
+    for (std::uint32_t index : m_dirtyIndices) {
+        const glm::vec3 &p = m_positions[index];
+        const glm::quat &q = m_rotations[index];
+        const glm::vec3 &s = m_scalings[index];
+
+        // translate * mat4_cast(rotation) * scale, expanded to avoid the matrix products
+        float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+        float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+        float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+        glm::mat4 &m = m_modelMatrices[index];
+        m[0] = glm::vec4(1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz), 2.0f * (xz - wy), 0.0f) * s.x;
+        m[1] = glm::vec4(2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + wx), 0.0f) * s.y;
+        m[2] = glm::vec4(2.0f * (xz + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (xx + yy), 0.0f) * s.z;
+        m[3] = glm::vec4(p, 1.0f);
+
+        m_dirtyFlags[index] = 0;
+    }
+
+    std::size_t updatedCount = m_dirtyIndices.size();
+    m_dirtyIndices.clear();
+
+    return updatedCount;
+}
+
+void TransformStore::markDirty(std::size_t index)
+{
+    if (!m_dirtyFlags[index]) {
+        m_dirtyFlags[index] = 1;
+        m_dirtyIndices.push_back(static_cast<std::uint32_t>(index));
+    }
+}
+
+} // namespace Vitrae
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include "Vitrae/Debugging/PipelineDebugSink.hpp"
+
+#include <fstream>
+
+namespace Vitrae
+{
+
+PipelineDebugSink::PipelineDebugSink()
+    : m_enabled(false), m_directory("shaderdebug"), m_writing(false), m_stopping(false)
+{}
+
+PipelineDebugSink::~PipelineDebugSink()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_stopping = true;
+    }
+    m_queueCondition.notify_all();
+
+    if (m_writerThread.joinable()) {
+        m_writerThread.join();
+    }
+}
+
+void PipelineDebugSink::setEnabled(bool enabled)
+{
+    m_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void PipelineDebugSink::setDirectory(std::filesystem::path directory)
+{
+    std::lock_guard lock(m_mutex);
+    m_directory = std::move(directory);
+}
+
+std::filesystem::path PipelineDebugSink::getFilePath(StringView filename) const
+{
+    std::lock_guard lock(m_mutex);
+    return m_directory / filename;
+}
+
+void PipelineDebugSink::write(String filename, String content)
+{
+    if (!isEnabled()) {
+        return;
+    }
+
+    {
+        std::lock_guard lock(m_mutex);
+        m_queue.emplace_back(m_directory / filename, std::move(content));
+
+        if (!m_writerThread.joinable()) {
+            m_writerThread = std::thread(&PipelineDebugSink::writerLoop, this);
+        }
+    }
+    m_queueCondition.notify_one();
+}
+
+void PipelineDebugSink::flush()
+{
+    std::unique_lock lock(m_mutex);
+    m_flushCondition.wait(lock, [&]() { return m_queue.empty() && !m_writing; });
+}
+
+void PipelineDebugSink::writerLoop()
+{
+    std::unique_lock lock(m_mutex);
+
+    while (true) {
+        m_queueCondition.wait(lock, [&]() { return !m_queue.empty() || m_stopping; });
+
+        if (m_queue.empty()) {
+            return;
+        }
+
+        auto [path, content] = std::move(m_queue.front());
+        m_queue.pop_front();
+        m_writing = true;
+
+        lock.unlock();
+        {
+            // debug output is best effort, so failures are ignored
+            std::error_code error;
+            std::filesystem::create_directories(path.parent_path(), error);
+
+            std::ofstream file(path);
+            file << content;
+        }
+        lock.lock();
+
+        m_writing = false;
+        if (m_queue.empty()) {
+            m_flushCondition.notify_all();
+        }
+    }
+}
+
+} // namespace Vitrae
\ No newline at end of file
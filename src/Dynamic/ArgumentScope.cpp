@@ -1,38 +1,71 @@
 #include "Vitrae/Dynamic/ArgumentScope.hpp"
 
+#include <cassert>
+
 namespace Vitrae
 {
 
-ArgumentScope::ArgumentScope() : mp_scope(nullptr), mp_propertySelection(nullptr) {}
-
-ArgumentScope::ArgumentScope(VariantScope *scope, const ParamAliases *propertySelection)
-    : mp_scope(scope), mp_propertySelection(propertySelection)
+ArgumentScope::ArgumentScope() : mp_scope(nullptr), mp_propertySelection(nullptr), mp_slots(nullptr)
 {}
 
+ArgumentScope::ArgumentScope(VariantScope *scope, const ParamAliases *propertySelection,
+                             const ParamSlotTable *p_slots)
+    : mp_scope(scope), mp_propertySelection(propertySelection), mp_slots(p_slots)
+{
+    assert(!mp_slots || mp_scope->getSlotTable() == mp_slots);
+}
+
+std::size_t ArgumentScope::slotFor(StringId key) const
+{
+    return mp_slots ? mp_slots->findRequestedSlot(key) : ParamSlotTable::NO_SLOT;
+}
+
 void ArgumentScope::set(StringId key, const Variant &value)
 {
+    if (std::size_t slot = slotFor(key); slot != ParamSlotTable::NO_SLOT) {
+        mp_scope->setSlot(slot, value);
+        return;
+    }
+
     StringId actualKey = mp_propertySelection->choiceFor(key);
     mp_scope->set(actualKey, value);
 }
 
 void ArgumentScope::set(StringId key, Variant &&value)
 {
+    if (std::size_t slot = slotFor(key); slot != ParamSlotTable::NO_SLOT) {
+        mp_scope->setSlot(slot, std::move(value));
+        return;
+    }
+
     StringId actualKey = mp_propertySelection->choiceFor(key);
     mp_scope->set(actualKey, std::move(value));
 }
 
 const Variant &ArgumentScope::get(StringId key) const
 {
+    if (std::size_t slot = slotFor(key); slot != ParamSlotTable::NO_SLOT) {
+        return mp_scope->getSlot(slot);
+    }
+
     StringId actualKey = mp_propertySelection->choiceFor(key);
     return mp_scope->get(actualKey);
 }
 Variant ArgumentScope::move(StringId key)
 {
+    if (std::size_t slot = slotFor(key); slot != ParamSlotTable::NO_SLOT) {
+        return mp_scope->moveSlot(slot);
+    }
+
     StringId actualKey = mp_propertySelection->choiceFor(key);
     return mp_scope->move(actualKey);
 }
 bool ArgumentScope::has(StringId key) const
 {
+    if (std::size_t slot = slotFor(key); slot != ParamSlotTable::NO_SLOT) {
+        return mp_scope->hasSlot(slot);
+    }
+
     StringId actualKey = mp_propertySelection->choiceFor(key);
     return mp_scope->has(actualKey);
 }
@@ -5,21 +5,35 @@
 namespace Vitrae
 {
 
-VariantScope::VariantScope() : m_parent{nullptr} {}
-VariantScope::VariantScope(const VariantScope *parent) : m_parent{parent} {}
+VariantScope::VariantScope() : m_parent{nullptr}, mp_slots{nullptr} {}
+VariantScope::VariantScope(const VariantScope *parent) : m_parent{parent}, mp_slots{nullptr} {}
 
 void VariantScope::set(StringId key, const Variant &value)
 {
+    if (std::size_t slot = findSlot(key); slot != ParamSlotTable::NO_SLOT) {
+        setSlot(slot, value);
+        return;
+    }
+
     m_dict[key] = value;
 }
 
 void VariantScope::set(StringId key, Variant &&value)
 {
+    if (std::size_t slot = findSlot(key); slot != ParamSlotTable::NO_SLOT) {
+        setSlot(slot, std::move(value));
+        return;
+    }
+
     m_dict[key] = std::move(value);
 }
 
 const Variant &VariantScope::get(StringId key) const
 {
+    if (std::size_t slot = findSlot(key); slot != ParamSlotTable::NO_SLOT) {
+        return getSlot(slot);
+    }
+
     auto it = m_dict.find(key);
     if (it != m_dict.end())
         return (*it).second;
@@ -32,6 +46,10 @@ const Variant &VariantScope::get(StringId key) const
 
 Variant VariantScope::move(StringId key)
 {
+    if (std::size_t slot = findSlot(key); slot != ParamSlotTable::NO_SLOT) {
+        return moveSlot(slot);
+    }
+
     auto it = m_dict.find(key);
     if (it != m_dict.end())
         return std::move((*it).second);
@@ -46,6 +64,16 @@ Variant VariantScope::move(StringId key)
 
 const Variant *VariantScope::getPtr(StringId key) const
 {
+    if (std::size_t slot = findSlot(key); slot != ParamSlotTable::NO_SLOT) {
+        if (m_slotValues[slot].has_value())
+            return &m_slotValues[slot].value();
+
+        if (m_parent)
+            return m_parent->getPtr(key);
+
+        return nullptr;
+    }
+
     auto it = m_dict.find(key);
     if (it != m_dict.end())
         return &((*it).second);
@@ -58,12 +86,87 @@ const Variant *VariantScope::getPtr(StringId key) const
 
 bool VariantScope::has(StringId key) const
 {
+    if (std::size_t slot = findSlot(key); slot != ParamSlotTable::NO_SLOT) {
+        return hasSlot(slot);
+    }
+
     return m_dict.find(key) != m_dict.end() || (m_parent && m_parent->has(key));
 }
 
 void VariantScope::clear()
 {
     m_dict.clear();
+    for (auto &value : m_slotValues) {
+        value.reset();
+    }
+}
+
+void VariantScope::bindSlots(const ParamSlotTable *p_slots)
+{
+    // move the values of the old slots back to the dictionary
+    if (mp_slots) {
+        for (std::size_t slot = 0; slot < m_slotValues.size(); ++slot) {
+            if (m_slotValues[slot].has_value()) {
+                m_dict[mp_slots->getActualName(slot)] = std::move(m_slotValues[slot].value());
+            }
+        }
+    }
+    m_slotValues.clear();
+
+    mp_slots = p_slots;
+
+    // move the values of the new slots out of the dictionary
+    if (mp_slots) {
+        m_slotValues.resize(mp_slots->size());
+        for (std::size_t slot = 0; slot < m_slotValues.size(); ++slot) {
+            StringId name = mp_slots->getActualName(slot);
+            auto it = m_dict.find(name);
+            if (it != m_dict.end()) {
+                m_slotValues[slot].emplace(std::move((*it).second));
+                m_dict.erase(name);
+            }
+        }
+    }
+}
+
+void VariantScope::setSlot(std::size_t slot, const Variant &value)
+{
+    m_slotValues[slot] = value;
+}
+
+void VariantScope::setSlot(std::size_t slot, Variant &&value)
+{
+    m_slotValues[slot] = std::move(value);
+}
+
+const Variant &VariantScope::getSlot(std::size_t slot) const
+{
+    if (m_slotValues[slot].has_value())
+        return m_slotValues[slot].value();
+
+    if (m_parent)
+        return m_parent->get(mp_slots->getActualName(slot));
+
+    throw std::runtime_error{"Key not found"};
+}
+
+Variant VariantScope::moveSlot(std::size_t slot)
+{
+    if (m_slotValues[slot].has_value())
+        return std::move(m_slotValues[slot].value());
+
+    if (m_parent) {
+        m_slotValues[slot].emplace(m_parent->get(mp_slots->getActualName(slot)));
+        return std::move(m_slotValues[slot].value());
+    }
+
+    throw std::runtime_error{"Key not found"};
+}
+
+bool VariantScope::hasSlot(std::size_t slot) const
+{
+    return m_slotValues[slot].has_value() ||
+           (m_parent && m_parent->has(mp_slots->getActualName(slot)));
 }
 
 } // namespace Vitrae
\ No newline at end of file
@@ -4,182 +4,191 @@
 
 namespace Vitrae {
 
-ParamAliases::ParamAliases() : m_parentPtrs{}, m_hash(0) {}
+ParamAliases::ParamAliases() : m_hash(0) {}
 
-namespace
+ParamAliases::ParamAliases(const StableMap<StringId, String> &aliases) : m_hash(0)
 {
-StableMap<StringId, std::pair<StringId, String>> convertAliases(
-    const StableMap<StringId, String> &aliases)
+    addLocalAliases(aliases);
+    resolveAliases();
+}
+
+ParamAliases::ParamAliases(std::initializer_list<std::pair<StringId, String>> aliases)
+    : ParamAliases(StableMap<StringId, String>(aliases))
+{}
+
+ParamAliases::ParamAliases(StableMap<StringId, String> &&aliases) : m_hash(0)
 {
-    StableMap<StringId, std::pair<StringId, String>> result;
-    for (const auto &[key, value] : aliases) {
-        if (key != value)
-            result.emplace(key, std::make_pair<StringId, String>(StringId(value), String(value)));
-    }
-    return result;
+    addLocalAliases(aliases);
+    resolveAliases();
 }
 
-} // namespace
+ParamAliases::ParamAliases(std::span<const ParamAliases *const> parentPtrs) : m_hash(0)
+{
+    addParentAliases(parentPtrs);
+    resolveAliases();
+}
 
-ParamAliases::ParamAliases(const StableMap<StringId, String> &aliases)
-    : m_parentPtrs{}, m_localAliases(convertAliases(aliases)), m_hash(0)
+ParamAliases::ParamAliases(std::span<const ParamAliases *const> parentPtrs,
+                           const StableMap<StringId, String> &aliases)
+    : m_hash(0)
 {
-    for (const auto &[key, value] : m_localAliases) {
-        m_hash ^=
-            combinedHashes<2>({{std::hash<StringId>{}(key), std::hash<StringId>{}(value.first)}});
-    }
+    // local aliases take priority over the parents'
+    addLocalAliases(aliases);
+    addParentAliases(parentPtrs);
+    resolveAliases();
 }
 
-ParamAliases::ParamAliases(std::initializer_list<std::pair<StringId, String>> aliases)
-    : ParamAliases(StableMap<StringId, String>(aliases))
-{}
+ParamAliases::ParamAliases(std::span<const ParamAliases *const> parentPtrs,
+                           StableMap<StringId, String> &&aliases)
+    : m_hash(0)
+{
+    // local aliases take priority over the parents'
+    addLocalAliases(aliases);
+    addParentAliases(parentPtrs);
+    resolveAliases();
+}
 
-ParamAliases::ParamAliases(StableMap<StringId, String> &&aliases)
-    : m_parentPtrs{}, m_localAliases(convertAliases(aliases)), m_hash(0)
+void ParamAliases::addLocalAliases(const StableMap<StringId, String> &aliases)
 {
-    for (const auto &[key, value] : m_localAliases) {
-        m_hash ^=
-            combinedHashes<2>({{std::hash<StringId>{}(key), std::hash<StringId>{}(value.first)}});
+    m_directAliases.reserve(m_directAliases.size() + aliases.size());
+    for (const auto &[key, value] : aliases) {
+        StringId valueId = value;
+        if (key != valueId) {
+            m_directAliases.emplace(key, std::make_pair(valueId, String(value)));
+        }
     }
 }
 
-ParamAliases::ParamAliases(std::span<const ParamAliases *const> parentPtrs)
-    : m_parentPtrs(parentPtrs.begin(), parentPtrs.end()), m_hash(0)
+void ParamAliases::addParentAliases(std::span<const ParamAliases *const> parentPtrs)
 {
+    // earlier parents take priority, and emplace doesn't overwrite
     for (const auto *p_parent : parentPtrs) {
-        m_hash ^= p_parent->hash();
+        m_directAliases.reserve(m_directAliases.size() + p_parent->m_directAliases.size());
+        for (const auto &[key, value] : p_parent->m_directAliases) {
+            m_directAliases.emplace(key, value);
+        }
     }
 }
 
-ParamAliases::ParamAliases(std::span<const ParamAliases *const> parentPtrs,
-                           const StableMap<StringId, String> &aliases)
-    : m_parentPtrs(parentPtrs.begin(), parentPtrs.end()), m_localAliases(convertAliases(aliases)),
-      m_hash(0)
+void ParamAliases::resolveAliases()
 {
-    for (const auto *p_parent : parentPtrs) {
-        m_hash ^= p_parent->hash();
+    m_resolvedAliases.reserve(m_directAliases.size());
+    for (const auto &[proxy, directChoice] : m_directAliases) {
+        const std::pair<StringId, String> *p_choice = &directChoice;
+        for (auto it = m_directAliases.find(p_choice->first); it != m_directAliases.end();
+             it = m_directAliases.find(p_choice->first)) {
+            p_choice = &(*it).second;
+        }
+        m_resolvedAliases.emplace(proxy, *p_choice);
     }
 
-    for (const auto &[key, value] : m_localAliases) {
-        m_hash ^=
-            combinedHashes<2>({{std::hash<StringId>{}(key), std::hash<StringId>{}(value.first)}});
+    recalculateHash();
+}
+
+void ParamAliases::recalculateHash()
+{
+    // The hash depends only on the final set of direct aliases, not on their order or the parents
+    // they came from. A sum of mixed hashes is used since a xor would cancel out equal terms
+    m_hash = m_directAliases.size();
+    for (const auto &[proxy, choice] : m_directAliases) {
+        m_hash += mixedHash(combinedHashes<2>(
+            {{std::hash<StringId>{}(proxy), std::hash<StringId>{}(choice.first)}}));
     }
 }
 
-ParamAliases::ParamAliases(std::span<const ParamAliases *const> parentPtrs,
-                           StableMap<StringId, String> &&aliases)
-    : m_parentPtrs(parentPtrs.begin(), parentPtrs.end()), m_localAliases(convertAliases(aliases)),
-      m_hash(0)
+bool ParamAliases::operator==(const ParamAliases &other) const
 {
-    for (const auto *p_parent : parentPtrs) {
-        m_hash ^= p_parent->hash();
+    if (m_hash != other.m_hash || m_directAliases.size() != other.m_directAliases.size()) {
+        return false;
     }
 
-    for (const auto &[key, value] : m_localAliases) {
-        m_hash ^=
-            combinedHashes<2>({{std::hash<StringId>{}(key), std::hash<StringId>{}(value.first)}});
+    for (const auto &[proxy, choice] : m_directAliases) {
+        auto it = other.m_directAliases.find(proxy);
+        if (it == other.m_directAliases.end() || (*it).second.first != choice.first) {
+            return false;
+        }
     }
+    return true;
 }
 
 StringId ParamAliases::choiceFor(StringId target) const
 {
-    StringId choice = target;
-
-    std::optional<StringId> optNextChoice;
-    while ((optNextChoice = directChoiceFor(choice)).has_value()) {
-        choice = optNextChoice.value();
+    auto it = m_resolvedAliases.find(target);
+    if (it != m_resolvedAliases.end()) {
+        return (*it).second.first;
+    } else {
+        return target;
     }
-
-    return choice;
 }
 
 String ParamAliases::choiceStringFor(String target) const
 {
-    String choice = target;
-
-    std::optional<String> optNextChoice;
-    while ((optNextChoice = directChoiceStringFor(choice)).has_value()) {
-        choice = optNextChoice.value();
+    auto it = m_resolvedAliases.find(target);
+    if (it != m_resolvedAliases.end()) {
+        return (*it).second.second;
+    } else {
+        return target;
     }
-
-    return choice;
 }
 
 std::optional<StringId> ParamAliases::directChoiceFor(StringId key) const
 {
-    auto it = m_localAliases.find(key);
-    if (it != m_localAliases.end()) {
+    auto it = m_directAliases.find(key);
+    if (it != m_directAliases.end()) {
         return (*it).second.first;
     } else {
-        for (auto p_parent : m_parentPtrs) {
-            auto c = p_parent->directChoiceFor(key);
-            if (c.has_value()) {
-                return c;
-            }
-        }
         return {};
     }
 }
 
 std::optional<String> ParamAliases::directChoiceStringFor(StringId key) const
 {
-    auto it = m_localAliases.find(key);
-    if (it != m_localAliases.end()) {
+    auto it = m_directAliases.find(key);
+    if (it != m_directAliases.end()) {
         return (*it).second.second;
     } else {
-        for (auto p_parent : m_parentPtrs) {
-            auto c = p_parent->directChoiceStringFor(key);
-            if (c.has_value()) {
-                return c;
-            }
-        }
         return {};
     }
 }
 
-void ParamAliases::extractAliasStrings(std::unordered_map<StringId, String> &aliases) const
+ParamAliases ParamAliases::subset(std::span<const StringId> proxies) const
 {
-    std::unordered_set<StringId> targets;
-    extractAliasProxyIds(targets);
-
-    for (const auto &target : targets) {
-        std::optional<String> optChoiceString = directChoiceStringFor(target);
-        if (optChoiceString.has_value()) {
-            String choiceString = optChoiceString.value();
-            while ((optChoiceString = directChoiceStringFor(choiceString)).has_value()) {
-                choiceString = optChoiceString.value();
-            }
-            aliases.emplace(target, choiceString);
+    ParamAliases ret;
+    ret.m_directAliases.reserve(proxies.size());
+    ret.m_resolvedAliases.reserve(proxies.size());
+
+    for (StringId proxy : proxies) {
+        auto it = m_resolvedAliases.find(proxy);
+        if (it != m_resolvedAliases.end()) {
+            // the final providers aren't proxies themselves, so the direct aliases are resolved
+            ret.m_directAliases.emplace(proxy, (*it).second);
+            ret.m_resolvedAliases.emplace(proxy, (*it).second);
         }
     }
+    ret.recalculateHash();
+
+    return ret;
+}
+
+void ParamAliases::extractAliasStrings(std::unordered_map<StringId, String> &aliases) const
+{
+    for (const auto &[target, choice] : m_resolvedAliases) {
+        aliases.emplace(target, choice.second);
+    }
 }
 
 void ParamAliases::extractAliasNameIds(std::unordered_map<StringId, StringId> &aliases) const
 {
-    std::unordered_set<StringId> targets;
-    extractAliasProxyIds(targets);
-
-    for (const auto &target : targets) {
-        std::optional<StringId> optChoice = directChoiceFor(target);
-        if (optChoice.has_value()) {
-            StringId choice = optChoice.value();
-            while ((optChoice = directChoiceFor(choice)).has_value()) {
-                choice = optChoice.value();
-            }
-            aliases.emplace(target, choice);
-        }
+    for (const auto &[target, choice] : m_resolvedAliases) {
+        aliases.emplace(target, choice.first);
     }
 }
 
 void ParamAliases::extractAliasProxyIds(std::unordered_set<StringId> &targets) const
 {
-    for (const auto &[key, value] : m_localAliases) {
+    for (const auto &[key, value] : m_directAliases) {
         targets.insert(key);
     }
-
-    for (auto p_parent : m_parentPtrs) {
-        p_parent->extractAliasProxyIds(targets);
-    }
 }
 
 } // namespace Vitrae
\ No newline at end of file
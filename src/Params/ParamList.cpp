@@ -1,74 +1,108 @@
 #include "Vitrae/Params/ParamList.hpp"
+#include "Vitrae/Containers/FlatHashMap.hpp"
+
+#include <mutex>
+#include <utility>
 
 namespace Vitrae
 {
 
-ParamList::ParamList(std::initializer_list<const ParamSpec> specs)
+namespace
 {
-    for (const auto &spec : specs) {
-        m_specNameIds.push_back(spec.name);
-        m_specList.push_back(spec);
-        m_mappedSpecs.emplace(spec.name, spec);
+/**
+ * The interned storages by their hash. Storages remove themselves when destroyed
+ */
+template <class StorageT> struct InternTable
+{
+    std::mutex mutex;
+    FlatHashMap<std::size_t, std::vector<std::weak_ptr<const StorageT>>> storagesPerHash;
+
+    static InternTable &get()
+    {
+        // never destroyed, since interned lists can outlive other statics
+        static InternTable *p_table = new InternTable;
+        return *p_table;
     }
+};
+} // namespace
 
-    recalculateHash();
-}
+ParamList::ParamList() : mp_storage(getEmptyStorage()) {}
 
-ParamList::ParamList(const StableMap<StringId, ParamSpec> &mappedSpecs) : m_mappedSpecs(mappedSpecs)
+ParamList::ParamList(ParamList &&other)
+    : mp_storage(std::exchange(other.mp_storage, getEmptyStorage()))
+{}
+
+ParamList::ParamList(std::initializer_list<const ParamSpec> specs)
 {
-    for (auto [nameId, spec] : m_mappedSpecs) {
-        m_specNameIds.push_back(nameId);
-        m_specList.push_back(spec);
+    auto p_storage = std::make_shared<Storage>();
+    p_storage->specNameIds.reserve(specs.size());
+    p_storage->specList.reserve(specs.size());
+    for (const auto &spec : specs) {
+        p_storage->specNameIds.push_back(spec.name);
+        p_storage->specList.push_back(spec);
     }
 
-    recalculateHash();
+    rebuildMappedSpecs(*p_storage);
+    recalculateHash(*p_storage);
+    mp_storage = std::move(p_storage);
 }
 
+ParamList::ParamList(const StableMap<StringId, ParamSpec> &mappedSpecs)
+    : ParamList(StableMap<StringId, ParamSpec>(mappedSpecs))
+{}
+
 ParamList::ParamList(StableMap<StringId, ParamSpec> &&mappedSpecs)
-    : m_mappedSpecs(std::move(mappedSpecs))
 {
-    for (auto [nameId, spec] : m_mappedSpecs) {
-        m_specNameIds.push_back(nameId);
-        m_specList.push_back(spec);
+    auto p_storage = std::make_shared<Storage>();
+    p_storage->mappedSpecs = std::move(mappedSpecs);
+    p_storage->specNameIds.reserve(p_storage->mappedSpecs.size());
+    p_storage->specList.reserve(p_storage->mappedSpecs.size());
+    for (auto [nameId, spec] : p_storage->mappedSpecs) {
+        p_storage->specNameIds.push_back(nameId);
+        p_storage->specList.push_back(spec);
     }
 
-    recalculateHash();
+    recalculateHash(*p_storage);
+    mp_storage = std::move(p_storage);
 }
 
-ParamList &ParamList::operator=(const ParamList &other)
+ParamList &ParamList::operator=(ParamList &&other)
 {
-    m_mappedSpecs = other.m_mappedSpecs;
-    m_specNameIds = other.m_specNameIds;
-    m_specList = std::vector<ParamSpec>(other.m_specList.begin(), other.m_specList.end());
-    m_hash = other.m_hash;
+    if (this != &other) {
+        mp_storage = std::exchange(other.mp_storage, getEmptyStorage());
+    }
     return *this;
 }
 
 std::size_t ParamList::merge(const ParamList &other)
 {
     std::size_t count = 0;
-    for (const auto &spec : other.m_specList) {
-        if (m_mappedSpecs.find(spec.name) == m_mappedSpecs.end()) {
-            m_mappedSpecs.emplace(spec.name, spec);
-            m_specNameIds.push_back(spec.name);
-            m_specList.push_back(spec);
+    for (const auto &spec : other.getSpecList()) {
+        if (!contains(spec.name)) {
+            Storage &storage = getModifiableStorage();
+            storage.mappedSpecs.emplace(spec.name, spec);
+            storage.specNameIds.push_back(spec.name);
+            storage.specList.push_back(spec);
             ++count;
         }
     }
 
-    recalculateHash();
+    if (count > 0) {
+        recalculateHash(getModifiableStorage());
+    }
 
     return count;
 }
 
 void ParamList::insert_back(const ParamSpec &spec)
 {
-    if (m_mappedSpecs.find(spec.name) == m_mappedSpecs.end()) {
-        m_mappedSpecs.emplace(spec.name, spec);
-        m_specNameIds.push_back(spec.name);
-        m_specList.push_back(spec);
+    if (!contains(spec.name)) {
+        Storage &storage = getModifiableStorage();
+        storage.mappedSpecs.emplace(spec.name, spec);
+        storage.specNameIds.push_back(spec.name);
+        storage.specList.push_back(spec);
 
-        recalculateHash();
+        recalculateHash(storage);
     }
 }
 
@@ -79,40 +113,157 @@ void ParamList::erase(const ParamSpec &spec)
 
 void ParamList::erase(const StringId &nameId)
 {
-    if (m_mappedSpecs.erase(nameId) > 0) {
-        m_mappedSpecs.erase(nameId);
+    if (contains(nameId)) {
+        Storage &storage = getModifiableStorage();
+        storage.mappedSpecs.erase(nameId);
         std::size_t ind =
-            std::find(m_specNameIds.begin(), m_specNameIds.end(), nameId) - m_specNameIds.begin();
-        m_specNameIds.erase(m_specNameIds.begin() + ind);
+            std::find(storage.specNameIds.begin(), storage.specNameIds.end(), nameId) -
+            storage.specNameIds.begin();
+        storage.specNameIds.erase(storage.specNameIds.begin() + ind);
 
         // we need a new vector to avoid calling std::vector::erase (ParamSpec is not
         // move-assignable)
         std::vector<ParamSpec> newSpecList;
-        newSpecList.reserve(m_specList.size() - 1);
-        for (int i = 0; i < m_specList.size(); i++) {
+        newSpecList.reserve(storage.specList.size() - 1);
+        for (std::size_t i = 0; i < storage.specList.size(); i++) {
             if (i != ind) {
-                newSpecList.push_back(m_specList[i]);
+                newSpecList.push_back(storage.specList[i]);
+            }
+        }
+        storage.specList = std::move(newSpecList);
+
+        recalculateHash(storage);
+    }
+}
+
+void ParamList::intern()
+{
+    if (mp_storage->interned) {
+        return;
+    }
+    if (mp_storage->specList.empty()) {
+        mp_storage = getEmptyStorage();
+        return;
+    }
+    for (const ParamSpec &spec : mp_storage->specList) {
+        if (spec.defaultValue.getAssignedTypeInfo() != TYPE_INFO<void>) {
+            return;
+        }
+    }
+
+    auto isEqualStorage = [](const Storage &a, const Storage &b) {
+        if (a.specNameIds != b.specNameIds) {
+            return false;
+        }
+        for (std::size_t i = 0; i < a.specList.size(); ++i) {
+            if (a.specList[i].typeInfo != b.specList[i].typeInfo) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    InternTable<Storage> &table = InternTable<Storage>::get();
+
+    // released after unlocking, since destroying an interned storage locks the table
+    std::shared_ptr<const Storage> p_previousStorage = std::move(mp_storage);
+    std::vector<std::shared_ptr<const Storage>> candidateStorages;
+    {
+        std::lock_guard lock(table.mutex);
+
+        auto [it, inserted] = table.storagesPerHash.emplace(p_previousStorage->hash);
+        std::vector<std::weak_ptr<const Storage>> &storages = (*it).second;
+
+        for (const auto &p_weakStorage : storages) {
+            if (auto p_candidate = p_weakStorage.lock()) {
+                candidateStorages.push_back(p_candidate);
+                if (isEqualStorage(*p_candidate, *p_previousStorage)) {
+                    mp_storage = std::move(p_candidate);
+                    break;
+                }
             }
         }
-        m_specList = std::move(newSpecList);
+        if (mp_storage) {
+            return;
+        }
+
+        // intern a copy, or the storage itself if this list is its only user
+        Storage *p_newStorage =
+            p_previousStorage.use_count() == 1
+                ? new Storage(std::move(const_cast<Storage &>(*p_previousStorage)))
+                : new Storage(*p_previousStorage);
+        p_newStorage->interned = true;
 
-        recalculateHash();
+        std::shared_ptr<const Storage> p_internedStorage(p_newStorage, [](const Storage *p) {
+            InternTable<Storage> &table = InternTable<Storage>::get();
+            {
+                std::lock_guard lock(table.mutex);
+
+                if (auto it = table.storagesPerHash.find(p->hash);
+                    it != table.storagesPerHash.end()) {
+                    std::erase_if((*it).second, [](const auto &p_weakStorage) {
+                        return p_weakStorage.expired();
+                    });
+                    if ((*it).second.empty()) {
+                        table.storagesPerHash.erase(it);
+                    }
+                }
+            }
+            delete p;
+        });
+        storages.push_back(p_internedStorage);
+        mp_storage = std::move(p_internedStorage);
     }
 }
 
 bool ParamList::contains(StringId nameId) const
 {
-    return m_mappedSpecs.find(nameId) != m_mappedSpecs.end();
+    return mp_storage->mappedSpecs.find(nameId) != mp_storage->mappedSpecs.end();
+}
+
+ParamList::Storage &ParamList::getModifiableStorage()
+{
+    // interned storages are shared with future lists, even if not currently
+    if (mp_storage.use_count() != 1 || mp_storage->interned) {
+        auto p_storage = std::make_shared<Storage>(*mp_storage);
+        p_storage->interned = false;
+        mp_storage = std::move(p_storage);
+    }
+
+    // only this list uses the storage, so it can be modified in place
+    return const_cast<Storage &>(*mp_storage);
+}
+
+const std::shared_ptr<const ParamList::Storage> &ParamList::getEmptyStorage()
+{
+    static const std::shared_ptr<const Storage> p_emptyStorage = []() {
+        auto p_storage = std::make_shared<Storage>();
+        p_storage->interned = true;
+        return p_storage;
+    }();
+    return p_emptyStorage;
+}
+
+void ParamList::rebuildMappedSpecs(Storage &storage)
+{
+    std::vector<std::pair<StringId, const ParamSpec &>> namedSpecs;
+    namedSpecs.reserve(storage.specList.size());
+    for (std::size_t i = 0; i < storage.specList.size(); i++) {
+        namedSpecs.emplace_back(storage.specNameIds[i], storage.specList[i]);
+    }
+
+    storage.mappedSpecs.clear();
+    storage.mappedSpecs.insert_range(namedSpecs.begin(), namedSpecs.end());
 }
 
-void ParamList::recalculateHash()
+void ParamList::recalculateHash(Storage &storage)
 {
-    m_hash = 0;
-    for (int i = 0; i < m_specList.size(); i++) {
-        m_hash = combinedHashes<3>({{
-            m_hash,
-            std::hash<StringId>{}(m_specNameIds[i]),
-            m_specList[i].typeInfo.p_id->hash_code(),
+    storage.hash = 0;
+    for (std::size_t i = 0; i < storage.specList.size(); i++) {
+        storage.hash = combinedHashes<3>({{
+            storage.hash,
+            std::hash<StringId>{}(storage.specNameIds[i]),
+            storage.specList[i].typeInfo.hash(),
         }});
     }
 }
@@ -0,0 +1,42 @@
+#include "Vitrae/Params/ParamSlotTable.hpp"
+
+namespace Vitrae
+{
+
+std::size_t ParamSlotTable::addSlot(StringId actualName)
+{
+    auto [it, inserted] = m_slotPerActualName.emplace(actualName, m_actualNames.size());
+    if (inserted) {
+        m_actualNames.push_back(actualName);
+        m_slotPerRequestedName.emplace(actualName, (*it).second);
+    }
+    return (*it).second;
+}
+
+void ParamSlotTable::addRequestedName(StringId requestedName, StringId actualName)
+{
+    std::size_t slot = findSlot(actualName);
+    if (slot != NO_SLOT) {
+        m_slotPerRequestedName[requestedName] = slot;
+    }
+}
+
+std::size_t ParamSlotTable::findSlot(StringId actualName) const
+{
+    auto it = m_slotPerActualName.find(actualName);
+    if (it != m_slotPerActualName.end()) {
+        return (*it).second;
+    }
+    return NO_SLOT;
+}
+
+std::size_t ParamSlotTable::findRequestedSlot(StringId requestedName) const
+{
+    auto it = m_slotPerRequestedName.find(requestedName);
+    if (it != m_slotPerRequestedName.end()) {
+        return (*it).second;
+    }
+    return NO_SLOT;
+}
+
+} // namespace Vitrae
\ No newline at end of file
@@ -1,12 +1,14 @@
 #include "Vitrae/Pipelines/Compositing/AdaptTasks.hpp"
 #include "Vitrae/Collections/ComponentRoot.hpp"
 #include "Vitrae/Collections/MethodCollection.hpp"
+#include "Vitrae/Debugging/PipelineDebugSink.hpp"
 #include "Vitrae/Debugging/PipelineExport.hpp"
+#include "Vitrae/Pipelines/PipelineCache.hpp"
 
 #include "MMeter.h"
 
-#include <fstream>
 #include <ranges>
+#include <sstream>
 
 namespace Vitrae {
 
@@ -19,12 +21,7 @@ std::size_t ComposeAdaptTasks::memory_cost() const
 
 const ParamList &ComposeAdaptTasks::getInputSpecs(const ParamAliases &externalAliases) const
 {
-    if (auto it = m_adaptorPerSelectionHash.find(externalAliases.hash());
-        it != m_adaptorPerSelectionHash.end()) {
-        return (*it).second->inputSpecs;
-    } else {
-        return EMPTY_PROPERTY_LIST;
-    }
+    return keepSpecList(getAdaptorPerAliases(externalAliases, m_params.root)->inputSpecs);
 }
 
 const ParamList &ComposeAdaptTasks::getOutputSpecs() const
@@ -34,30 +31,20 @@ const ParamList &ComposeAdaptTasks::getOutputSpecs() const
 
 const ParamList &ComposeAdaptTasks::getFilterSpecs(const ParamAliases &externalAliases) const
 {
-    if (auto it = m_adaptorPerSelectionHash.find(externalAliases.hash());
-        it != m_adaptorPerSelectionHash.end()) {
-        return (*it).second->filterSpecs;
-    } else {
-        return EMPTY_PROPERTY_LIST;
-    }
+    return keepSpecList(getAdaptorPerAliases(externalAliases, m_params.root)->filterSpecs);
 }
 
 const ParamList &ComposeAdaptTasks::getConsumingSpecs(const ParamAliases &externalAliases) const
 {
-    if (auto it = m_adaptorPerSelectionHash.find(externalAliases.hash());
-        it != m_adaptorPerSelectionHash.end()) {
-        return (*it).second->consumeSpecs;
-    } else {
-        return EMPTY_PROPERTY_LIST;
-    }
+    return keepSpecList(getAdaptorPerAliases(externalAliases, m_params.root)->consumeSpecs);
 }
 
 void ComposeAdaptTasks::extractUsedTypes(std::set<const TypeInfo *> &typeSet,
                                          const ParamAliases &aliases) const
 {
-    if (auto it = m_adaptorPerSelectionHash.find(aliases.hash());
-        it != m_adaptorPerSelectionHash.end()) {
-        const auto &specs = *(*it).second;
+    if (std::shared_ptr<const AdaptorPerAliases> p_adaptor = findAdaptorPerAliases(aliases);
+        p_adaptor) {
+        const auto &specs = *p_adaptor;
 
         for (const ParamList *p_specs : {&specs.inputSpecs, &m_params.desiredOutputs,
                                          &specs.filterSpecs, &specs.consumeSpecs}) {
@@ -77,9 +64,9 @@ void ComposeAdaptTasks::extractSubTasks(std::set<const Task *> &taskSet,
 const Pipeline<ComposeTask> &ComposeAdaptTasks::getContainedPipeline(
     const ParamAliases &aliases) const
 {
-    if (auto it = m_adaptorPerSelectionHash.find(aliases.hash());
-        it != m_adaptorPerSelectionHash.end()) {
-        return (*it).second->pipeline;
+    if (std::shared_ptr<const AdaptorPerAliases> p_adaptor = findAdaptorPerAliases(aliases);
+        p_adaptor) {
+        return *p_adaptor->p_pipeline;
     }
 
     throw std::runtime_error{"Adaptor not found"};
@@ -87,8 +74,7 @@ const Pipeline<ComposeTask> &ComposeAdaptTasks::getContainedPipeline(
 
 ParamAliases ComposeAdaptTasks::constructContainedPipelineAliases(const ParamAliases &aliases) const
 {
-    if (auto it = m_adaptorPerSelectionHash.find(aliases.hash());
-        it != m_adaptorPerSelectionHash.end()) {
+    if (findAdaptorPerAliases(aliases)) {
         return ParamAliases({{&m_params.adaptorAliases, &aliases}});
     }
 
@@ -97,60 +83,96 @@ ParamAliases ComposeAdaptTasks::constructContainedPipelineAliases(const ParamAli
 
 void ComposeAdaptTasks::rebuildContainedPipeline(const ParamAliases &aliases) const
 {
-    if (auto it = m_adaptorPerSelectionHash.find(aliases.hash());
-        it != m_adaptorPerSelectionHash.end()) {
+    std::shared_ptr<const AdaptorPerAliases> p_adaptor = takeAdaptorPerAliases(aliases);
 
-        std::unique_ptr<AdaptorPerAliases> p_adaptor = std::move((*it).second);
-        m_adaptorPerSelectionHash.erase(it);
+    if (p_adaptor) {
         ParamAliases subAliases({{&m_params.adaptorAliases, &aliases}});
 
-        for (auto p_pipeitem : p_adaptor->pipeline.items) {
+        for (auto p_pipeitem : p_adaptor->p_pipeline->items) {
             if (auto p_container = dynamic_cast<const PipelineContainer *>(&*p_pipeitem);
                 p_container) {
                 p_container->rebuildContainedPipeline(subAliases);
             }
         }
 
-        m_adaptorPerSelectionHash.emplace(
-            aliases.hash(),
-            new AdaptorPerAliases(m_params.adaptorAliases, m_params.desiredOutputs, aliases,
-                                  m_params.root.getComponent<MethodCollection>(),
-                                  m_params.friendlyName));
+        auto p_newAdaptor = std::make_shared<const AdaptorPerAliases>(
+            m_params.adaptorAliases, m_params.desiredOutputs, aliases, m_params.root,
+            m_params.friendlyName);
+
+        std::lock_guard lock(m_adaptorMutex);
+        m_adaptorPerSelection.emplace(aliases, std::move(p_newAdaptor));
+    }
+}
+
+bool ComposeAdaptTasks::isContainedPipelineAffected(const ParamAliases &oldAliases,
+                                                    const ParamAliases &newAliases) const
+{
+    std::shared_ptr<const AdaptorPerAliases> p_adaptor = findAdaptorPerAliases(oldAliases);
+    if (!p_adaptor) {
+        return true;
+    }
+
+    const AdaptorPerAliases &adaptor = *p_adaptor;
+    ParamAliases newSubAliases({{&m_params.adaptorAliases, &newAliases}});
+
+    return isPipelineAffected(*adaptor.p_pipeline, adaptor.subAliases, newSubAliases);
+}
+
+void ComposeAdaptTasks::retargetContainedPipeline(const ParamAliases &oldAliases,
+                                                  const ParamAliases &newAliases) const
+{
+    if (oldAliases == newAliases) {
+        return;
+    }
+
+    std::shared_ptr<const AdaptorPerAliases> p_oldAdaptor = findAdaptorPerAliases(oldAliases);
+    if (!p_oldAdaptor) {
+        return;
     }
+
+    // the task is shared, so other users can still be on the old aliases.
+    // The old adaptor is kept, and its copy shares the contained pipeline
+    auto p_adaptor = std::make_shared<AdaptorPerAliases>(*p_oldAdaptor);
+    ParamAliases newSubAliases({{&m_params.adaptorAliases, &newAliases}});
+
+    retargetContainedPipelines(*p_adaptor->p_pipeline, p_adaptor->subAliases, newSubAliases);
+
+    p_adaptor->subAliases = std::move(newSubAliases);
+
+    // a displaced adaptor is destroyed once its remaining users are done with it
+    std::lock_guard lock(m_adaptorMutex);
+    m_adaptorPerSelection[newAliases] = std::move(p_adaptor);
 }
 
 void ComposeAdaptTasks::run(RenderComposeContext ctx) const
 {
     MMETER_SCOPE_PROFILER(m_params.friendlyName.c_str());
 
-    auto it = m_adaptorPerSelectionHash.find(ctx.aliases.hash());
-    if (it == m_adaptorPerSelectionHash.end()) {
-        it = m_adaptorPerSelectionHash
-                 .emplace(ctx.aliases.hash(),
-                          new AdaptorPerAliases(
-                              m_params.adaptorAliases, m_params.desiredOutputs, ctx.aliases,
-                              ctx.root.getComponent<MethodCollection>(), m_params.friendlyName))
-                 .first;
-        throw ComposeTaskRequirementsChangedException();
+    // held while running, since the adaptor can be forgotten meanwhile
+    std::shared_ptr<const AdaptorPerAliases> p_adaptor = findAdaptorPerAliases(ctx.aliases);
+    if (!p_adaptor) {
+        // the adaptor is created while solving the rebuilt pipeline
+        ctx.requests.requestRebuild();
+        return;
     }
 
-    const AdaptorPerAliases &adaptor = *(*it).second;
+    const AdaptorPerAliases &adaptor = *p_adaptor;
 
     // VariantScope encapsulatedScope(&ctx.properties.getUnaliasedScope());
 
     // Note: we will use only the pipeline's usedSelection in the subpipeline,
     // because anything else is unused and potential performance hog
     ArgumentScope encapsulatedArgumentScope(&ctx.properties.getUnaliasedScope(),
-                                            &adaptor.pipeline.usedSelection);
+                                            &adaptor.p_pipeline->usedSelection);
 
     // construct the encapsulated context
-    const ParamAliases *aliasArray[] = {&m_params.adaptorAliases, &ctx.aliases};
-    ParamAliases subAliases(aliasArray);
+    ComposeRequests subRequests;
     RenderComposeContext subCtx{
         .properties = encapsulatedArgumentScope,
         .root = ctx.root,
-        .aliases = subAliases,
+        .aliases = adaptor.subAliases,
         .pipelineMemory = ctx.pipelineMemory,
+        .requests = subRequests,
     };
 
     // map from external scope to internal scope
@@ -165,15 +187,27 @@ void ComposeAdaptTasks::run(RenderComposeContext ctx) const
         {
             MMETER_SCOPE_PROFILER("Pipeline execution");
 
-            for (auto &pipeitem : adaptor.pipeline.items) {
+            for (auto &pipeitem : adaptor.p_pipeline->items) {
                 pipeitem->run(subCtx);
+                if (subRequests.hasRequests()) {
+                    break;
+                }
             }
         }
     }
     catch (const ComposeTaskRequirementsChangedException &) {
+        subRequests.requestRebuild();
+    }
+
+    if (subRequests.isRebuildRequested()) {
         // Prepare for rebuild and notify parent runner to rebuild
         forgetAdaptorPerAliases(ctx.aliases);
-        throw;
+        ctx.requests.requestRebuild();
+        return;
+    }
+    if (subRequests.isPreparationRequested()) {
+        ctx.requests.requestPreparation();
+        return;
     }
 
     // map from internal scope to external scope
@@ -186,34 +220,31 @@ void ComposeAdaptTasks::prepareRequiredLocalAssets(RenderComposeContext ctx) con
 {
     MMETER_SCOPE_PROFILER("ComposeAdaptTasks::run");
 
-    auto it = m_adaptorPerSelectionHash.find(ctx.aliases.hash());
-    if (it == m_adaptorPerSelectionHash.end()) {
-        it = m_adaptorPerSelectionHash
-                 .emplace(ctx.aliases.hash(),
-                          new AdaptorPerAliases(
-                              m_params.adaptorAliases, m_params.desiredOutputs, ctx.aliases,
-                              ctx.root.getComponent<MethodCollection>(), m_params.friendlyName))
-                 .first;
-        throw ComposeTaskRequirementsChangedException();
+    // held while running, since the adaptor can be forgotten meanwhile
+    std::shared_ptr<const AdaptorPerAliases> p_adaptor = findAdaptorPerAliases(ctx.aliases);
+    if (!p_adaptor) {
+        // the adaptor is created while solving the rebuilt pipeline
+        ctx.requests.requestRebuild();
+        return;
     }
 
-    const AdaptorPerAliases &adaptor = *(*it).second;
+    const AdaptorPerAliases &adaptor = *p_adaptor;
 
     // VariantScope encapsulatedScope(&ctx.properties.getUnaliasedScope());
 
     // Note: we will use only the pipeline's usedSelection in the subpipeline,
     // because anything else is unused and potential performance hog
     ArgumentScope encapsulatedArgumentScope(&ctx.properties.getUnaliasedScope(),
-                                            &adaptor.pipeline.usedSelection);
+                                            &adaptor.p_pipeline->usedSelection);
 
     // construct the encapsulated context
-    const ParamAliases *aliasArray[] = {&m_params.adaptorAliases, &ctx.aliases};
-    ParamAliases subAliases(aliasArray);
+    ComposeRequests subRequests;
     RenderComposeContext subCtx{
         .properties = encapsulatedArgumentScope,
         .root = ctx.root,
-        .aliases = subAliases,
+        .aliases = adaptor.subAliases,
         .pipelineMemory = ctx.pipelineMemory,
+        .requests = subRequests,
     };
 
     // map from external scope to internal scope
@@ -228,15 +259,27 @@ void ComposeAdaptTasks::prepareRequiredLocalAssets(RenderComposeContext ctx) con
         {
             MMETER_SCOPE_PROFILER("Pipeline execution");
 
-            for (auto &pipeitem : std::ranges::reverse_view{adaptor.pipeline.items}) {
+            for (auto &pipeitem : std::ranges::reverse_view{adaptor.p_pipeline->items}) {
                 pipeitem->prepareRequiredLocalAssets(subCtx);
+                if (subRequests.hasRequests()) {
+                    break;
+                }
             }
         }
     }
     catch (const ComposeTaskRequirementsChangedException &) {
+        subRequests.requestRebuild();
+    }
+
+    if (subRequests.isRebuildRequested()) {
         // Prepare for rebuild and notify parent runner to rebuild
         forgetAdaptorPerAliases(ctx.aliases);
-        throw;
+        ctx.requests.requestRebuild();
+        return;
+    }
+    if (subRequests.isPreparationRequested()) {
+        ctx.requests.requestPreparation();
+        return;
     }
 
     // map from internal scope to external scope
@@ -252,36 +295,84 @@ StringView ComposeAdaptTasks::getFriendlyName() const
     return m_params.friendlyName;
 }
 
-const ComposeAdaptTasks::AdaptorPerAliases &ComposeAdaptTasks::getAdaptorPerAliases(
-    const ParamAliases &externalAliases, const MethodCollection &methodCollection) const
+std::shared_ptr<const ComposeAdaptTasks::AdaptorPerAliases> ComposeAdaptTasks::
+    findAdaptorPerAliases(const ParamAliases &externalAliases) const
+{
+    std::lock_guard lock(m_adaptorMutex);
+
+    if (auto it = m_adaptorPerSelection.find(externalAliases); it != m_adaptorPerSelection.end()) {
+        return (*it).second;
+    }
+    return nullptr;
+}
+
+std::shared_ptr<const ComposeAdaptTasks::AdaptorPerAliases> ComposeAdaptTasks::
+    getAdaptorPerAliases(const ParamAliases &externalAliases, ComponentRoot &root) const
+{
+    if (std::shared_ptr<const AdaptorPerAliases> p_adaptor =
+            findAdaptorPerAliases(externalAliases);
+        p_adaptor) {
+        return p_adaptor;
+    }
+
+    // built without locking, since solving the contained pipeline can take a while
+    auto p_newAdaptor = std::make_shared<const AdaptorPerAliases>(
+        m_params.adaptorAliases, m_params.desiredOutputs, externalAliases, root,
+        m_params.friendlyName);
+
+    std::lock_guard lock(m_adaptorMutex);
+    auto [it, inserted] = m_adaptorPerSelection.emplace(externalAliases, std::move(p_newAdaptor));
+    return (*it).second;
+}
+
+std::shared_ptr<const ComposeAdaptTasks::AdaptorPerAliases> ComposeAdaptTasks::
+    takeAdaptorPerAliases(const ParamAliases &externalAliases) const
 {
-    auto it = m_adaptorPerSelectionHash.find(externalAliases.hash());
-    if (it == m_adaptorPerSelectionHash.end()) {
-        it = m_adaptorPerSelectionHash
-                 .emplace(externalAliases.hash(),
-                          new AdaptorPerAliases(m_params.adaptorAliases, m_params.desiredOutputs,
-                                                externalAliases, methodCollection,
-                                                m_params.friendlyName))
-                 .first;
-
-        return *(*it).second;
-    }
-    return *(*it).second;
+    std::lock_guard lock(m_adaptorMutex);
+
+    std::shared_ptr<const AdaptorPerAliases> p_adaptor;
+    if (auto it = m_adaptorPerSelection.find(externalAliases); it != m_adaptorPerSelection.end()) {
+        p_adaptor = std::move((*it).second);
+        m_adaptorPerSelection.erase(it);
+    }
+    return p_adaptor;
 }
 
 void ComposeAdaptTasks::forgetAdaptorPerAliases(const ParamAliases &externalAliases) const
 {
-    m_adaptorPerSelectionHash.erase(externalAliases.hash());
+    std::lock_guard lock(m_adaptorMutex);
+
+    // its users hold their own references, so it is destroyed once they are done
+    if (auto it = m_adaptorPerSelection.find(externalAliases); it != m_adaptorPerSelection.end()) {
+        m_adaptorPerSelection.erase(it);
+    }
+}
+
+const ParamList &ComposeAdaptTasks::keepSpecList(const ParamList &specs) const
+{
+    std::lock_guard lock(m_adaptorMutex);
+
+    auto [it, inserted] = m_keptSpecListsPerHash.emplace(specs.getHash());
+    std::vector<std::unique_ptr<const ParamList>> &keptLists = (*it).second;
+
+    // lists with default values aren't interned, so only their shared storage proves equality
+    for (const auto &p_keptList : keptLists) {
+        if (specs.isInterned() ? *p_keptList == specs
+                               : p_keptList->getSpecList().data() == specs.getSpecList().data()) {
+            return *p_keptList;
+        }
+    }
+    keptLists.push_back(std::make_unique<const ParamList>(specs));
+    return *keptLists.back();
 }
 
 ComposeAdaptTasks::AdaptorPerAliases::AdaptorPerAliases(const ParamAliases &adaptorAliases,
                                                         const ParamList &desiredOutputs,
                                                         const ParamAliases &externalAliases,
-                                                        const MethodCollection &methodCollection,
+                                                        ComponentRoot &root,
                                                         StringView friendlyName)
+    : subAliases({{&adaptorAliases, &externalAliases}})
 {
-    ParamAliases subAliases({{&adaptorAliases, &externalAliases}});
-
     // All desired outputs must be aliased
     for (auto desiredSpec : desiredOutputs.getSpecList()) {
         auto alias = subAliases.choiceFor(desiredSpec.name);
@@ -310,26 +401,25 @@ ComposeAdaptTasks::AdaptorPerAliases::AdaptorPerAliases(const ParamAliases &adap
     // don't depend on our aliases
     std::vector<StringId> parameterProviderIdsVec(parameterProviderIds.begin(),
                                                   parameterProviderIds.end());
-    pipeline =
-        Pipeline<ComposeTask>(methodCollection.getComposeMethod(), parameterProviderIdsVec,
-                              PipelineParametrizationPolicy::ParametrizedOrDirectDependencies,
-                              desiredOutputs, subAliases);
-
-    String filePrefix = std::string("shaderdebug/") + "adaptor_" + String(friendlyName) +
-                        getPipelineId(pipeline, subAliases);
-    {
-        std::ofstream file;
-        String filename = filePrefix + ".dot";
-        file.open(filename);
-        exportPipeline(pipeline, subAliases, file);
-        file.close();
+    p_pipeline = root.getComponent<PipelineCache<ComposeTask>>().getPipeline(
+        root.getComponent<MethodCollection>().getComposeMethod(), parameterProviderIdsVec,
+        PipelineParametrizationPolicy::ParametrizedOrDirectDependencies, desiredOutputs,
+        subAliases);
+
+    if (PipelineDebugSink &debugSink = root.getComponent<PipelineDebugSink>();
+        debugSink.isEnabled()) {
+        String filename = "adaptor_" + String(friendlyName) + "_" +
+                          toHexString(p_pipeline->fingerprint, 16) + ".dot";
+        std::stringstream graph;
+        exportPipeline(*p_pipeline, subAliases, graph);
+        debugSink.write(std::move(filename), graph.str());
     }
 
     using ListConvPair = std::pair<const ParamList *, ParamList *>;
 
-    for (auto [p_specs, p_targetSpecs] : {ListConvPair{&pipeline.inputSpecs, &inputSpecs},
-                                          ListConvPair{&pipeline.filterSpecs, &filterSpecs},
-                                          ListConvPair{&pipeline.consumingSpecs, &consumeSpecs}}) {
+    for (auto [p_specs, p_targetSpecs] : {ListConvPair{&p_pipeline->inputSpecs, &inputSpecs},
+                                          ListConvPair{&p_pipeline->filterSpecs, &filterSpecs},
+                                          ListConvPair{&p_pipeline->consumingSpecs, &consumeSpecs}}) {
         for (auto &spec : p_specs->getSpecList()) {
             p_targetSpecs->insert_back(ParamSpec{
                 .name = subAliases.choiceStringFor(spec.name),
@@ -337,6 +427,7 @@ ComposeAdaptTasks::AdaptorPerAliases::AdaptorPerAliases(const ParamAliases &adap
                 .defaultValue = spec.defaultValue,
             });
         }
+        p_targetSpecs->intern();
     }
 
     for (auto [desiredId, desiredSpec] : desiredOutputs.getMappedSpecs()) {
@@ -345,7 +436,7 @@ ComposeAdaptTasks::AdaptorPerAliases::AdaptorPerAliases(const ParamAliases &adap
         bool found = false;
 
         // check if it's in the outputs
-        for (auto [nameId, spec] : pipeline.outputSpecs.getMappedSpecs()) {
+        for (auto [nameId, spec] : p_pipeline->outputSpecs.getMappedSpecs()) {
             auto innerChoice = subAliases.choiceFor(nameId);
             if (outerChoice == innerChoice) {
                 if (spec.typeInfo != TYPE_INFO<void>) {
@@ -357,7 +448,7 @@ ComposeAdaptTasks::AdaptorPerAliases::AdaptorPerAliases(const ParamAliases &adap
         }
 
         // check if it's in the filters
-        for (auto [nameId, spec] : pipeline.filterSpecs.getMappedSpecs()) {
+        for (auto [nameId, spec] : p_pipeline->filterSpecs.getMappedSpecs()) {
             auto innerChoice = subAliases.choiceFor(nameId);
             if (outerChoice == innerChoice) {
                 if (desiredId != innerChoice) {
@@ -373,7 +464,7 @@ ComposeAdaptTasks::AdaptorPerAliases::AdaptorPerAliases(const ParamAliases &adap
         }
 
         // check if it's in the pipethroughs
-        for (auto [nameId, spec] : pipeline.pipethroughSpecs.getMappedSpecs()) {
+        for (auto [nameId, spec] : p_pipeline->pipethroughSpecs.getMappedSpecs()) {
             auto innerChoice = subAliases.choiceFor(nameId);
             if (outerChoice == innerChoice) {
                 if (desiredId != innerChoice) {
@@ -41,6 +41,11 @@ void ComposeConstant::run(RenderComposeContext ctx) const
 
 void ComposeConstant::prepareRequiredLocalAssets(RenderComposeContext ctx) const {}
 
+bool ComposeConstant::canRunConcurrently() const
+{
+    return true;
+}
+
 StringView ComposeConstant::getFriendlyName() const
 {
     return m_friendlyName;
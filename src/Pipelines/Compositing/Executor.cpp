@@ -0,0 +1,123 @@
+#include "Vitrae/Pipelines/Compositing/Executor.hpp"
+
+#include "MMeter.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+
+namespace Vitrae
+{
+
+namespace
+{
+struct ExecutionState
+{
+    const Pipeline<ComposeTask> &pipeline;
+    const TaskGraph<ComposeTask> &graph;
+    RenderComposeContext ctx;
+    WorkStealingPool &pool;
+
+    std::unique_ptr<std::atomic<std::size_t>[]> remainingDependencies;
+    std::atomic<bool> aborted;
+
+    // guards the following members and waking of the calling thread
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::size_t numUnfinished;
+    std::exception_ptr p_exception;
+
+    void runItem(std::size_t index)
+    {
+        // like sequential runs, no tasks are started after anything was requested
+        if (!aborted && !ctx.requests.hasRequests()) {
+            try {
+                pipeline.items[index]->run(ctx);
+            }
+            catch (...) {
+                std::lock_guard lock(mutex);
+                if (!p_exception) {
+                    p_exception = std::current_exception();
+                }
+                aborted = true;
+            }
+        }
+
+        // dependents of skipped tasks are skipped too, but still released so the run can finish
+        bool anyReadyOnCaller = false;
+        for (std::size_t dependent : graph.nodes[index].dependents) {
+            if (remainingDependencies[dependent].fetch_sub(1) == 1) {
+                if (pipeline.items[dependent]->canRunConcurrently()) {
+                    pool.submit([this, dependent]() { runItem(dependent); });
+                } else {
+                    anyReadyOnCaller = true;
+                }
+            }
+        }
+
+        // the calling thread can return as soon as it sees the count drop, so it is locked
+        std::lock_guard lock(mutex);
+        --numUnfinished;
+        if (anyReadyOnCaller || numUnfinished == 0) {
+            condition.notify_all();
+        }
+    }
+};
+} // namespace
+
+ComposeExecutor::ComposeExecutor(std::size_t numWorkers) : m_pool(numWorkers) {}
+
+void ComposeExecutor::run(const Pipeline<ComposeTask> &pipeline,
+                          const TaskGraph<ComposeTask> &graph, RenderComposeContext ctx)
+{
+    MMETER_SCOPE_PROFILER("ComposeExecutor::run");
+
+    std::size_t numItems = pipeline.items.size();
+
+    ExecutionState state{
+        .pipeline = pipeline,
+        .graph = graph,
+        .ctx = ctx,
+        .pool = m_pool,
+        .remainingDependencies = std::make_unique<std::atomic<std::size_t>[]>(numItems),
+        .aborted = false,
+        .numUnfinished = numItems,
+    };
+
+    for (std::size_t index = 0; index < numItems; ++index) {
+        state.remainingDependencies[index] = graph.nodes[index].dependencies.size();
+    }
+
+    // start the independent concurrent tasks
+    for (std::size_t index = 0; index < numItems; ++index) {
+        if (graph.nodes[index].dependencies.empty() &&
+            pipeline.items[index]->canRunConcurrently()) {
+            m_pool.submit([&state, index]() { state.runItem(index); });
+        }
+    }
+
+    // run the rest on this thread, in pipeline order
+    for (std::size_t index = 0; index < numItems; ++index) {
+        if (!pipeline.items[index]->canRunConcurrently()) {
+            {
+                std::unique_lock lock(state.mutex);
+                state.condition.wait(lock,
+                                     [&]() { return state.remainingDependencies[index] == 0; });
+            }
+            state.runItem(index);
+        }
+    }
+
+    {
+        std::unique_lock lock(state.mutex);
+        state.condition.wait(lock, [&]() { return state.numUnfinished == 0; });
+    }
+
+    if (state.p_exception) {
+        std::rethrow_exception(state.p_exception);
+    }
+}
+
+} // namespace Vitrae
\ No newline at end of file
@@ -89,14 +89,15 @@ void ComposeFrameToTexture::run(RenderComposeContext ctx) const
 
     glm::uvec2 retrSize = m_params.size.get(ctx.properties);
 
-    // reset the whole pipeline if the FrameStore size is invalid
+    // recreate the FrameStore if its size is invalid. The pipeline itself stays valid
     if (ctx.properties.get(StandardParam::fs_target.name)
             .get<dynasma::FirmPtr<FrameStore>>()
             ->getSize() != retrSize) {
         // Ensure the FrameStore gets deleted
         ctx.properties.set(StandardParam::fs_target.name, Variant());
 
-        throw ComposeTaskRequirementsChangedException();
+        ctx.requests.requestPreparation();
+        return;
     }
 
     // Everything should already be set
@@ -125,11 +126,14 @@ void ComposeFrameToTexture::prepareRequiredLocalAssets(RenderComposeContext ctx)
     ctx.properties.set(m_params.textureName, p_texture);
 
     /*
-    Now create the FB only if it didn't exist beforehand
+    Now create the FB only if it didn't exist beforehand, or has a stale size
     */
     if (!ctx.properties.has(StandardParam::fs_target.name) ||
         ctx.properties.get(StandardParam::fs_target.name).getAssignedTypeInfo() ==
-            TYPE_INFO<void>) {
+            TYPE_INFO<void> ||
+        ctx.properties.get(StandardParam::fs_target.name)
+                .get<dynasma::FirmPtr<FrameStore>>()
+                ->getSize() != retrSize) {
         auto p_frame =
             frameManager
                 .register_asset_k(FrameStore::TextureBindParams{
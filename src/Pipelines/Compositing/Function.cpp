@@ -7,7 +7,8 @@ namespace Vitrae
 
 ComposeFunction::ComposeFunction(const SetupParams &params)
     : mp_function(params.p_function), m_friendlyName(params.friendlyName),
-      m_inputSpecs(params.inputSpecs), m_outputSpecs(params.outputSpecs)
+      m_inputSpecs(params.inputSpecs), m_outputSpecs(params.outputSpecs),
+      m_canRunConcurrently(params.canRunConcurrently)
 {}
 
 std::size_t ComposeFunction::memory_cost() const
@@ -61,6 +62,11 @@ void ComposeFunction::run(RenderComposeContext args) const
 
 void ComposeFunction::prepareRequiredLocalAssets(RenderComposeContext args) const {}
 
+bool ComposeFunction::canRunConcurrently() const
+{
+    return m_canRunConcurrently;
+}
+
 StringView ComposeFunction::getFriendlyName() const
 {
     return m_friendlyName;
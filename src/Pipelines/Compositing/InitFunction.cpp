@@ -61,6 +61,12 @@ void ComposeInitFunction::prepareRequiredLocalAssets(RenderComposeContext args)
     mp_function(args);
 }
 
+bool ComposeInitFunction::canRunConcurrently() const
+{
+    // the function runs only while preparing
+    return true;
+}
+
 StringView ComposeInitFunction::getFriendlyName() const
 {
     return m_friendlyName;
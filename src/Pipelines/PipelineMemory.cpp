@@ -1,30 +1,36 @@
 #include "Vitrae/Pipelines/PipelineMemory.hpp"
 
+#include <ranges>
+
 namespace Vitrae
 {
-PipelineMemory::PipelineMemory() : m_nextAnyIndex(0) {}
+PipelineMemory::PipelineMemory() : m_nextEntryIndex(0) {}
 
-std::any &PipelineMemory::createNextAny()
+PipelineMemory::~PipelineMemory()
 {
-    ++m_nextAnyIndex;
-    return m_anyPool.emplace_back();
+    destroyEntries();
 }
 
-std::any &PipelineMemory::nextAny()
+void PipelineMemory::destroyEntries()
 {
-    return m_anyPool[m_nextAnyIndex++];
+    for (const Entry &entry : std::ranges::reverse_view{m_entries}) {
+        entry.destroy(entry.p_value);
+    }
+    m_entries.clear();
+    m_nextEntryIndex = 0;
 }
 
 RestartablePipelineMemory::RestartablePipelineMemory() {}
 
-void RestartablePipelineMemory::restart() {
-    m_nextAnyIndex = 0;
+void RestartablePipelineMemory::restart()
+{
+    m_nextEntryIndex = m_entries.size();
 }
 
 void RestartablePipelineMemory::clear()
 {
-    m_nextAnyIndex = 0;
-    m_anyPool.clear();
+    destroyEntries();
+    m_arena.release();
 }
 
 } // namespace Vitrae
\ No newline at end of file
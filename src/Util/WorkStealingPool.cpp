@@ -0,0 +1,122 @@
+#include "Vitrae/Util/WorkStealingPool.hpp"
+
+#include <stdexcept>
+
+namespace Vitrae
+{
+
+namespace
+{
+// the pool and index of the worker running on this thread, for submitting to the own queue
+thread_local const WorkStealingPool *tl_p_currentPool = nullptr;
+thread_local std::size_t tl_currentWorkerIndex = 0;
+} // namespace
+
+WorkStealingPool::WorkStealingPool(std::size_t numWorkers)
+    : m_numUnclaimedJobs(0), m_stopping(false), m_nextWorkerIndex(0)
+{
+    if (numWorkers == 0) {
+        throw std::invalid_argument("WorkStealingPool needs at least one worker");
+    }
+
+    m_workers.reserve(numWorkers);
+    for (std::size_t i = 0; i < numWorkers; ++i) {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+
+    m_threads.reserve(numWorkers);
+    for (std::size_t i = 0; i < numWorkers; ++i) {
+        m_threads.emplace_back(&WorkStealingPool::workerLoop, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard lock(m_sleepMutex);
+        m_stopping = true;
+    }
+    m_wakeCondition.notify_all();
+
+    for (auto &thread : m_threads) {
+        thread.join();
+    }
+}
+
+void WorkStealingPool::submit(Job job)
+{
+    std::size_t workerIndex;
+    if (tl_p_currentPool == this) {
+        workerIndex = tl_currentWorkerIndex;
+    } else {
+        std::lock_guard lock(m_sleepMutex);
+        workerIndex = m_nextWorkerIndex;
+        m_nextWorkerIndex = (m_nextWorkerIndex + 1) % m_workers.size();
+    }
+
+    {
+        Worker &worker = *m_workers[workerIndex];
+        std::lock_guard lock(worker.mutex);
+        worker.jobs.push_back(std::move(job));
+    }
+
+    {
+        std::lock_guard lock(m_sleepMutex);
+        ++m_numUnclaimedJobs;
+    }
+    m_wakeCondition.notify_one();
+}
+
+void WorkStealingPool::workerLoop(std::size_t workerIndex)
+{
+    tl_p_currentPool = this;
+    tl_currentWorkerIndex = workerIndex;
+
+    while (true) {
+        // claim a job before searching for it, so each claim is backed by a queued job
+        {
+            std::unique_lock lock(m_sleepMutex);
+            m_wakeCondition.wait(lock, [&]() { return m_numUnclaimedJobs > 0 || m_stopping; });
+
+            if (m_numUnclaimedJobs == 0) {
+                return;
+            }
+            --m_numUnclaimedJobs;
+        }
+
+        Job job;
+        while (!tryTakeJob(workerIndex, job)) {
+            // the claimed job is being pushed or was taken by a worker that didn't claim yet
+            std::this_thread::yield();
+        }
+
+        job();
+    }
+}
+
+bool WorkStealingPool::tryTakeJob(std::size_t workerIndex, Job &outJob)
+{
+    {
+        Worker &worker = *m_workers[workerIndex];
+        std::lock_guard lock(worker.mutex);
+        if (!worker.jobs.empty()) {
+            outJob = std::move(worker.jobs.back());
+            worker.jobs.pop_back();
+            return true;
+        }
+    }
+
+    for (std::size_t offset = 1; offset < m_workers.size(); ++offset) {
+        Worker &victim = *m_workers[(workerIndex + offset) % m_workers.size()];
+        std::lock_guard lock(victim.mutex);
+        if (!victim.jobs.empty()) {
+            outJob = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+} // namespace Vitrae
\ No newline at end of file
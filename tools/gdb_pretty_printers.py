@@ -155,15 +155,43 @@ def LazyPtr_Printer_func(val):
 gdb.pretty_printers.append(LazyPtr_Printer_func)
 
 # StringId
+STRINGID_TABLE_CAPACITY_BITS = 16
+
+
+def lookupStringIdName(hash):
+    # mirrors Vitrae::StringIdTable::lookup()
+    try:
+        hashes = gdb.parse_and_eval("Vitrae::StringIdTable::s_hashes")
+        strings = gdb.parse_and_eval("Vitrae::StringIdTable::s_strings")
+    except gdb.error:
+        return None
+    if hash == 0:
+        return None
+
+    capacity = 1 << STRINGID_TABLE_CAPACITY_BITS
+    slot = ((hash * 0x9E3779B97F4A7C15) & 0xFFFFFFFFFFFFFFFF) >> (
+        64 - STRINGID_TABLE_CAPACITY_BITS
+    )
+    for _ in range(capacity):
+        foundHash = int(hashes[slot])
+        if foundHash == hash:
+            p_str = strings[slot]
+            return p_str.string() if int(p_str) != 0 else None
+        if foundHash == 0:
+            return None
+        slot = (slot + 1) & (capacity - 1)
+    return None
+
+
 class StringId_Printer:
     def __init__(self, val):
         self.val = val
 
     def to_string(self):
         m_hash = int(self.val["m_hash"])
-        if any(field.name == "m_str" for field in self.val.type.fields()):
-            m_str = self.val["m_str"].string()
-            return f'<#{m_hash:x}> "{m_str}"'
+        name = lookupStringIdName(m_hash)
+        if name is not None:
+            return f'<#{m_hash:x}> "{name}"'
         else:
             return f"<#{m_hash:x}>"
 
@@ -212,13 +240,14 @@ class StableMap_Printer:
     def children(self):
         try:
             count = int(self.val["m_size"])
+            capacity = int(self.val["m_capacity"])
             data = self.val["m_data"]
             keys = data.reinterpret_cast(self.keyT.pointer())
             offset = (
-                (count * self.keyT.sizeof)
-                if self.mappedT.sizeof < self.keyT.sizeof
+                (capacity * self.keyT.sizeof)
+                if self.mappedT.alignof <= self.keyT.alignof
                 else (
-                    (count * self.keyT.sizeof + self.mappedT.alignof - 1)
+                    (capacity * self.keyT.sizeof + self.mappedT.alignof - 1)
                     // self.mappedT.alignof
                     * self.mappedT.alignof
                 )
@@ -240,6 +269,47 @@ def StableMap_Printer_func(val):
 gdb.pretty_printers.append(StableMap_Printer_func)
 
 
+# FlatHashMap
+class FlatHashMap_Printer:
+    def __init__(self, val):
+        self.val = val
+        self.keyT = val.type.template_argument(0)
+        self.mappedT = val.type.template_argument(1)
+
+    def to_string(self):
+        count = self.val["m_size"]
+        return f"{count}-sized FlatHashMap"
+
+    def children(self):
+        try:
+            capacity = int(self.val["m_capacity"])
+            data = self.val["m_data"]
+
+            def aligned(offset, alignment):
+                return (offset + alignment - 1) // alignment * alignment
+
+            keyOffset = aligned(capacity, self.keyT.alignof)
+            valueOffset = aligned(keyOffset + capacity * self.keyT.sizeof, self.mappedT.alignof)
+            occupancy = data.reinterpret_cast(gdb.lookup_type("unsigned char").pointer())
+            keys = (data[keyOffset].address).reinterpret_cast(self.keyT.pointer())
+            values = (data[valueOffset].address).reinterpret_cast(self.mappedT.pointer())
+            for i in range(capacity):
+                if int(occupancy[i]) != 0:
+                    yield (str(keys[i]), values[i])
+        except Exception as e:
+            print("FlatHashMap_Printer failed!")
+            print(e)
+            return
+
+
+def FlatHashMap_Printer_func(val):
+    if val.type.name is not None and val.type.name.startswith("Vitrae::FlatHashMap"):
+        return FlatHashMap_Printer(val)
+
+
+gdb.pretty_printers.append(FlatHashMap_Printer_func)
+
+
 class ParamList_Printer:
     def __init__(self, val):
         self.val = val